@@ -51,6 +51,7 @@ const std::map<int, uint32_t> ERROR_CODE_CONVERSION = {
     { E_SCREENLOCK_SENDREQUEST_FAILED, JsErrorCode::ERR_SERVICE_ABNORMAL },
     { E_SCREENLOCK_NOT_FOCUS_APP, JsErrorCode::ERR_ILLEGAL_USE },
     { E_SCREENLOCK_NOT_SYSTEM_APP, JsErrorCode::ERR_NOT_SYSTEM_APP },
+    { E_SCREENLOCK_LISTENER_OVERFLOW, JsErrorCode::ERR_SERVICE_ABNORMAL },
 };
 const std::map<uint32_t, std::string> ERROR_INFO_MAP = {
     { JsErrorCode::ERR_NO_PERMISSION, PERMISSION_VALIDATION_FAILED },
@@ -78,6 +79,7 @@ napi_status Init(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("getScreenLockAuthState", OHOS::ScreenLock::NAPI_GetScreenLockAuthState),
         DECLARE_NAPI_FUNCTION("requestStrongAuth", OHOS::ScreenLock::NAPI_RequestStrongAuth),
         DECLARE_NAPI_FUNCTION("getStrongAuth", OHOS::ScreenLock::NAPI_GetStrongAuth),
+        DECLARE_NAPI_FUNCTION("getLockSnapshot", OHOS::ScreenLock::NAPI_GetLockSnapshot),
     };
     napi_define_properties(env, exports, sizeof(exportFuncs) / sizeof(*exportFuncs), exportFuncs);
     return napi_ok;
@@ -761,6 +763,52 @@ napi_value NAPI_GetStrongAuth(napi_env env, napi_callback_info info)
     return result;
 }
 
+napi_value NAPI_GetLockSnapshot(napi_env env, napi_callback_info info)
+{
+    SCLOCK_HILOGD("NAPI_GetLockSnapshot in");
+    napi_value result = nullptr;
+    size_t argc = ARGS_SIZE_ONE;
+    napi_value argv[ARGS_SIZE_ONE] = { 0 };
+    napi_value thisVar = nullptr;
+    void *data = nullptr;
+    int userId = -1;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &thisVar, &data));
+    if (CheckParamNumber(argc, ARGS_SIZE_ONE) != napi_ok) {
+        ThrowError(env, JsErrorCode::ERR_INVALID_PARAMS, PARAMETER_VALIDATION_FAILED);
+        return result;
+    }
+    if (CheckParamType(env, argv[ARGV_ZERO], napi_number) != napi_ok) {
+        ThrowError(env, JsErrorCode::ERR_INVALID_PARAMS, PARAMETER_VALIDATION_FAILED);
+        return result;
+    }
+    napi_get_value_int32(env, argv[ARGV_ZERO], &userId);
+    ScreenLockStateSnapshot snapshot;
+    int32_t status = ScreenLockAppManager::GetInstance()->GetStateSnapshot(userId, snapshot);
+    if (status != E_SCREENLOCK_OK) {
+        ErrorInfo errInfo;
+        errInfo.errorCode_ = static_cast<uint32_t>(status);
+        GetErrorInfo(status, errInfo);
+        ThrowError(env, errInfo.errorCode_, errInfo.message_);
+        return result;
+    }
+    SCLOCK_HILOGI("NAPI_GetLockSnapshot [isLocked]=%{public}d", snapshot.isLocked);
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result));
+    napi_create_int32(env, snapshot.version, &value);
+    napi_set_named_property(env, result, "version", value);
+    napi_get_boolean(env, snapshot.isLocked, &value);
+    napi_set_named_property(env, result, "isLocked", value);
+    napi_get_boolean(env, snapshot.isSecure, &value);
+    napi_set_named_property(env, result, "isSecure", value);
+    napi_get_boolean(env, snapshot.isDisabled, &value);
+    napi_set_named_property(env, result, "isDisabled", value);
+    napi_create_int32(env, snapshot.authState, &value);
+    napi_set_named_property(env, result, "authState", value);
+    napi_create_int32(env, snapshot.strongAuthReason, &value);
+    napi_set_named_property(env, result, "strongAuthReason", value);
+    return result;
+}
+
 static napi_value ScreenlockInit(napi_env env, napi_value exports)
 {
     napi_status ret = Init(env, exports);
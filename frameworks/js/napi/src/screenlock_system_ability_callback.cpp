@@ -56,13 +56,15 @@ void ScreenlockSystemAbilityCallback::OnCallBack(const SystemEvent &systemEvent)
         napi_create_object(entry->env, &result);
         napi_value eventType = nullptr;
         napi_value params = nullptr;
-        napi_create_string_utf8(entry->env, entry->systemEvent.eventType_.c_str(), NAPI_AUTO_LENGTH, &eventType);
+        // Names are only materialized here, everything below the JS boundary works with the event id.
+        const std::string &eventName = entry->systemEvent.GetEventType();
+        napi_create_string_utf8(entry->env, eventName.c_str(), eventName.size(), &eventType);
         napi_create_string_utf8(entry->env, entry->systemEvent.params_.c_str(), NAPI_AUTO_LENGTH, &params);
         napi_set_named_property(entry->env, result, "eventType", eventType);
         napi_set_named_property(entry->env, result, "params", params);
         napi_value output = nullptr;
         napi_call_function(entry->env, nullptr, callbackFunc, ARGS_SIZE_ONE, &result, &output);
-        SCLOCK_HILOGI("OnCallBack eventType:%{public}s", entry->systemEvent.eventType_.c_str());
+        SCLOCK_HILOGI("OnCallBack eventType:%{public}s", eventName.c_str());
         napi_close_handle_scope(entry->env, scope);
     };
     handler_->PostTask(task, "ScreenlockSystemAbilityCallback");
@@ -16,8 +16,10 @@
 #ifndef SERVICES_INCLUDE_SCLOCK_SYSTEMAPP_MANAGER_H
 #define SERVICES_INCLUDE_SCLOCK_SYSTEMAPP_MANAGER_H
 
+#include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "iremote_object.h"
 #include "refbase.h"
@@ -47,6 +49,12 @@ public:
     SCREENLOCK_API int32_t GetScreenLockAuthState(int userId, int32_t &authState);
     SCREENLOCK_API int32_t RequestStrongAuth(int reasonFlag, int32_t userId);
     SCREENLOCK_API int32_t GetStrongAuth(int userId, int32_t &reasonFlag);
+    SCREENLOCK_API int32_t GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot);
+    SCREENLOCK_API int32_t SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+        const std::vector<std::string> &eventTypes);
+    SCREENLOCK_API int32_t UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener);
+    SCREENLOCK_API int32_t GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+        std::vector<SystemEvent> &events);
     SCREENLOCK_API void OnRemoteSaDied(const wptr<IRemoteObject> &object);
     SCREENLOCK_API sptr<ScreenLockManagerInterface> GetProxy();
 
@@ -57,6 +65,9 @@ private:
     static sptr<ScreenLockAppDeathRecipient> deathRecipient_;
     static std::mutex listenerLock_;
     static sptr<ScreenLockSystemAbilityInterface> systemEventListener_;
+    using Subscription = std::pair<sptr<ScreenLockSystemAbilityInterface>, std::vector<std::string>>;
+    std::mutex subscriptionLock_;
+    std::map<IRemoteObject *, Subscription> subscriptions_;
     std::mutex managerProxyLock_;
     sptr<ScreenLockManagerInterface> screenlockManagerProxy_;
 };
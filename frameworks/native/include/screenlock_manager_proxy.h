@@ -46,6 +46,13 @@ public:
     int32_t GetScreenLockAuthState(int userId, int32_t &authState) override;
     int32_t RequestStrongAuth(int reasonFlag, int32_t userId) override;
     int32_t GetStrongAuth(int userId, int32_t &reasonFlag) override;
+    int32_t GetSharedState(sptr<Ashmem> &ashmem, bool &isLockQueryAllowed) override;
+    int32_t GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot) override;
+    int32_t SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+        const std::vector<std::string> &eventTypes) override;
+    int32_t UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener) override;
+    int32_t GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+        std::vector<SystemEvent> &events) override;
 private:
     int32_t UnlockInner(MessageParcel &reply, int32_t command, const sptr<ScreenLockCallbackInterface> &listener);
     int32_t IsScreenLockedInner(MessageParcel &reply, uint32_t command);
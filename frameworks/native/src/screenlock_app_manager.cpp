@@ -141,6 +141,19 @@ int32_t ScreenLockAppManager::GetStrongAuth(int userId, int32_t &reasonFlag)
     return status;
 }
 
+int32_t ScreenLockAppManager::GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot)
+{
+    SCLOCK_HILOGD("ScreenLockAppManager::GetStateSnapshot in");
+    auto proxy = GetProxy();
+    if (proxy == nullptr) {
+        SCLOCK_HILOGE("ScreenLockAppManager::GetStateSnapshot quit because redoing GetProxy failed.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    int32_t status = proxy->GetStateSnapshot(userId, snapshot);
+    SCLOCK_HILOGD("ScreenLockAppManager::GetStateSnapshot out, status=%{public}d", status);
+    return status;
+}
+
 int32_t ScreenLockAppManager::OnSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener)
 {
     SCLOCK_HILOGD("ScreenLockAppManager::OnSystemEvent in");
@@ -161,6 +174,63 @@ int32_t ScreenLockAppManager::OnSystemEvent(const sptr<ScreenLockSystemAbilityIn
     return status;
 }
 
+int32_t ScreenLockAppManager::SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+    const std::vector<std::string> &eventTypes)
+{
+    SCLOCK_HILOGD("ScreenLockAppManager::SubscribeSystemEvent in");
+    auto proxy = GetProxy();
+    if (proxy == nullptr) {
+        SCLOCK_HILOGE("ScreenLockAppManager::SubscribeSystemEvent quit because redoing GetProxy failed.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    if (listener == nullptr || listener->AsObject() == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    int32_t status = proxy->SubscribeSystemEvent(listener, eventTypes);
+    if (status == E_SCREENLOCK_OK) {
+        std::lock_guard<std::mutex> autoLock(subscriptionLock_);
+        subscriptions_[listener->AsObject().GetRefPtr()] = Subscription(listener, eventTypes);
+    }
+    SCLOCK_HILOGD("ScreenLockAppManager::SubscribeSystemEvent out, status=%{public}d", status);
+    return status;
+}
+
+int32_t ScreenLockAppManager::UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener)
+{
+    SCLOCK_HILOGD("ScreenLockAppManager::UnsubscribeSystemEvent in");
+    if (listener == nullptr || listener->AsObject() == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    {
+        std::lock_guard<std::mutex> autoLock(subscriptionLock_);
+        subscriptions_.erase(listener->AsObject().GetRefPtr());
+    }
+    auto proxy = GetProxy();
+    if (proxy == nullptr) {
+        SCLOCK_HILOGE("ScreenLockAppManager::UnsubscribeSystemEvent quit because redoing GetProxy failed.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    int32_t status = proxy->UnsubscribeSystemEvent(listener);
+    SCLOCK_HILOGD("ScreenLockAppManager::UnsubscribeSystemEvent out, status=%{public}d", status);
+    return status;
+}
+
+int32_t ScreenLockAppManager::GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+    std::vector<SystemEvent> &events)
+{
+    SCLOCK_HILOGD("ScreenLockAppManager::GetMissedEvents in");
+    auto proxy = GetProxy();
+    if (proxy == nullptr) {
+        SCLOCK_HILOGE("ScreenLockAppManager::GetMissedEvents quit because redoing GetProxy failed.");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    int32_t status = proxy->GetMissedEvents(epoch, lastSeq, resync, events);
+    SCLOCK_HILOGD("ScreenLockAppManager::GetMissedEvents out, status=%{public}d", status);
+    return status;
+}
+
 sptr<ScreenLockManagerInterface> ScreenLockAppManager::GetScreenLockManagerProxy()
 {
     sptr<ISystemAbilityManager> systemAbilityManager =
@@ -195,6 +265,21 @@ void ScreenLockAppManager::OnRemoteSaDied(const wptr<IRemoteObject> &remote)
         SystemEvent systemEvent(SERVICE_RESTART);
         systemEventListener_->OnCallBack(systemEvent);
     }
+    std::map<IRemoteObject *, Subscription> subscriptions;
+    {
+        std::lock_guard<std::mutex> autoLock(subscriptionLock_);
+        subscriptions = subscriptions_;
+    }
+    auto proxy = GetProxy();
+    for (auto &[remote, subscription] : subscriptions) {
+        // The restarted service has no subscribers, register again before telling the subscriber.
+        if (proxy != nullptr) {
+            int32_t status = proxy->SubscribeSystemEvent(subscription.first, subscription.second);
+            SCLOCK_HILOGI("resubscribe system event, status=%{public}d", status);
+        }
+        SystemEvent systemEvent(SERVICE_RESTART);
+        subscription.first->OnCallBack(systemEvent);
+    }
 }
 
 sptr<ScreenLockManagerInterface> ScreenLockAppManager::GetProxy()
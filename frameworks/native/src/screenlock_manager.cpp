@@ -17,6 +17,9 @@
 #include "screenlock_manager_proxy.h"
 #include <hitrace_meter.h>
 
+#include <algorithm>
+#include <chrono>
+
 #include "if_system_ability_manager.h"
 #include "iservice_registry.h"
 #include "sclock_log.h"
@@ -25,6 +28,12 @@
 
 namespace OHOS {
 namespace ScreenLock {
+namespace {
+// A failed shared state request is asked again after this, doubling up to the maximum.
+constexpr std::chrono::milliseconds SHARED_STATE_RETRY_MIN(1000);
+constexpr std::chrono::milliseconds SHARED_STATE_RETRY_MAX(60000);
+} // namespace
+
 std::mutex ScreenLockManager::instanceLock_;
 sptr<ScreenLockManager> ScreenLockManager::instance_;
 ScreenLockManager::ScreenLockManager()
@@ -50,6 +59,12 @@ sptr<ScreenLockManager> ScreenLockManager::GetInstance()
 
 int32_t ScreenLockManager::IsLocked(bool &isLocked)
 {
+    SharedStateSnapshot snapshot;
+    bool isLockQueryAllowed = false;
+    if (ReadSharedState(snapshot, isLockQueryAllowed) && isLockQueryAllowed) {
+        isLocked = snapshot.isScreenlocked;
+        return E_SCREENLOCK_OK;
+    }
     auto proxy = GetProxy();
     if (proxy == nullptr) {
         SCLOCK_HILOGE("IsLocked quit because GetScreenLockManagerProxy failed.");
@@ -60,6 +75,11 @@ int32_t ScreenLockManager::IsLocked(bool &isLocked)
 
 bool ScreenLockManager::IsScreenLocked()
 {
+    SharedStateSnapshot snapshot;
+    bool isLockQueryAllowed = false;
+    if (ReadSharedState(snapshot, isLockQueryAllowed)) {
+        return snapshot.isScreenlocked;
+    }
     auto proxy = GetProxy();
     if (proxy == nullptr) {
         SCLOCK_HILOGE("IsScreenLocked quit because GetScreenLockManagerProxy failed.");
@@ -70,12 +90,41 @@ bool ScreenLockManager::IsScreenLocked()
 
 bool ScreenLockManager::GetSecure()
 {
+    SharedStateSnapshot snapshot;
+    bool isLockQueryAllowed = false;
+    bool isCacheable = stateCacheEnabled_ && ReadSharedState(snapshot, isLockQueryAllowed) &&
+        snapshot.credentialTracked;
+    if (isCacheable) {
+        std::lock_guard<std::mutex> autoLock(secureCacheLock_);
+        if (secureCache_.isValid && secureCache_.credentialEpoch == snapshot.credentialEpoch &&
+            secureCache_.currentUser == snapshot.currentUser) {
+            return secureCache_.isSecure;
+        }
+    }
     auto proxy = GetProxy();
     if (proxy == nullptr) {
         SCLOCK_HILOGE("GetSecure quit because redoing GetScreenLockManagerProxy failed.");
         return false;
     }
-    return proxy->GetSecure();
+    bool isSecure = proxy->GetSecure();
+    if (isCacheable) {
+        // Keyed by the epoch read before the request, so a change racing with it forces a refetch.
+        std::lock_guard<std::mutex> autoLock(secureCacheLock_);
+        secureCache_.isValid = true;
+        secureCache_.isSecure = isSecure;
+        secureCache_.currentUser = snapshot.currentUser;
+        secureCache_.credentialEpoch = snapshot.credentialEpoch;
+    }
+    return isSecure;
+}
+
+void ScreenLockManager::EnableStateCache(bool enable)
+{
+    SCLOCK_HILOGI("EnableStateCache enable = %{public}d", enable);
+    stateCacheEnabled_ = enable;
+    if (!enable) {
+        ResetSecureCache();
+    }
 }
 
 int32_t ScreenLockManager::Unlock(Action action, const sptr<ScreenLockCallbackInterface> &listener)
@@ -160,8 +209,55 @@ sptr<ScreenLockManagerInterface> ScreenLockManager::GetScreenLockManagerProxy()
     return screenlockServiceProxy;
 }
 
+bool ScreenLockManager::ReadSharedState(SharedStateSnapshot &snapshot, bool &isLockQueryAllowed)
+{
+    std::shared_ptr<ScreenLockSharedState> sharedState = nullptr;
+    {
+        std::lock_guard<std::mutex> autoLock(sharedStateLock_);
+        auto now = std::chrono::steady_clock::now();
+        if (sharedState_ == nullptr && now >= sharedStateRetryTime_) {
+            auto proxy = GetProxy();
+            sptr<Ashmem> ashmem = nullptr;
+            bool isAllowed = false;
+            if (proxy != nullptr && proxy->GetSharedState(ashmem, isAllowed) == E_SCREENLOCK_OK) {
+                auto attached = std::make_shared<ScreenLockSharedState>();
+                if (attached->Attach(ashmem)) {
+                    sharedState_ = attached;
+                    isLockQueryAllowed_ = isAllowed;
+                }
+            }
+            if (sharedState_ == nullptr) {
+                // Transient failures and old services without the page both keep the IPC path for a while.
+                sharedStateRetryDelay_ = std::clamp(sharedStateRetryDelay_ * 2, SHARED_STATE_RETRY_MIN,
+                    SHARED_STATE_RETRY_MAX);
+                sharedStateRetryTime_ = now + sharedStateRetryDelay_;
+            }
+        }
+        sharedState = sharedState_;
+        isLockQueryAllowed = isLockQueryAllowed_;
+    }
+    return sharedState != nullptr && sharedState->Read(snapshot);
+}
+
+void ScreenLockManager::ResetSharedState()
+{
+    std::lock_guard<std::mutex> autoLock(sharedStateLock_);
+    sharedState_ = nullptr;
+    isLockQueryAllowed_ = false;
+    sharedStateRetryTime_ = {};
+    sharedStateRetryDelay_ = std::chrono::milliseconds(0);
+}
+
+void ScreenLockManager::ResetSecureCache()
+{
+    std::lock_guard<std::mutex> autoLock(secureCacheLock_);
+    secureCache_ = SecureCache();
+}
+
 void ScreenLockManager::OnRemoteSaDied(const wptr<IRemoteObject> &remote)
 {
+    ResetSharedState();
+    ResetSecureCache();
     std::lock_guard<std::mutex> autoLock(managerProxyLock_);
     screenlockManagerProxy_ = GetScreenLockManagerProxy();
 }
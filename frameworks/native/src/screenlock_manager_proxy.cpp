@@ -358,5 +358,166 @@ int32_t ScreenLockManagerProxy::GetStrongAuth(int userId, int32_t &reasonFlag)
     SCLOCK_HILOGD("GetStrongAuth end retCode is %{public}d, %{public}d.", retCode, reasonFlag);
     return retCode;
 }
+
+int32_t ScreenLockManagerProxy::GetSharedState(sptr<Ashmem> &ashmem, bool &isLockQueryAllowed)
+{
+    MessageParcel reply;
+    int32_t ret =
+        IsScreenLockedInner(reply, static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::GET_SHARED_STATE));
+    if (ret != E_SCREENLOCK_OK) {
+        SCLOCK_HILOGE("GetSharedState, ret = %{public}d", ret);
+        return ret;
+    }
+    int32_t retCode = reply.ReadInt32();
+    if (retCode != E_SCREENLOCK_OK) {
+        SCLOCK_HILOGE("GetSharedState, retCode = %{public}d", retCode);
+        return retCode;
+    }
+    isLockQueryAllowed = reply.ReadBool();
+    ashmem = reply.ReadAshmem();
+    if (ashmem == nullptr) {
+        SCLOCK_HILOGE("GetSharedState, read ashmem failed");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    return E_SCREENLOCK_OK;
+}
+
+int32_t ScreenLockManagerProxy::GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteInt32(userId);
+
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::GET_STATE_SNAPSHOT), data, reply, option);
+    if (ret != ERR_NONE) {
+        SCLOCK_HILOGE("ScreenLockManagerProxy GetStateSnapshot, ret = %{public}d", ret);
+        return E_SCREENLOCK_SENDREQUEST_FAILED;
+    }
+    int32_t retCode = reply.ReadInt32();
+    if (retCode != E_SCREENLOCK_OK) {
+        SCLOCK_HILOGE("GetStateSnapshot, retCode = %{public}d", retCode);
+        return retCode;
+    }
+    snapshot.version = reply.ReadInt32();
+    if (snapshot.version < STATE_SNAPSHOT_VERSION) {
+        SCLOCK_HILOGE("GetStateSnapshot, unsupported version = %{public}d", snapshot.version);
+        return E_SCREENLOCK_READ_PARCEL_ERROR;
+    }
+    snapshot.isLocked = reply.ReadBool();
+    snapshot.isSecure = reply.ReadBool();
+    snapshot.isDisabled = reply.ReadBool();
+    snapshot.authState = reply.ReadInt32();
+    snapshot.strongAuthReason = reply.ReadInt32();
+    return E_SCREENLOCK_OK;
+}
+
+int32_t ScreenLockManagerProxy::SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+    const std::vector<std::string> &eventTypes)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    if (!data.WriteInterfaceToken(GetDescriptor())) {
+        SCLOCK_HILOGE(" Failed to write parcelable ");
+        return E_SCREENLOCK_WRITE_PARCEL_ERROR;
+    }
+    if (listener == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    if (!data.WriteRemoteObject(listener->AsObject().GetRefPtr()) || !data.WriteStringVector(eventTypes)) {
+        SCLOCK_HILOGE("write parcel failed.");
+        return E_SCREENLOCK_WRITE_PARCEL_ERROR;
+    }
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::SUBSCRIBE_SYSTEM_EVENT), data, reply, option);
+    if (ret != ERR_NONE) {
+        SCLOCK_HILOGE("ScreenLockManagerProxy SubscribeSystemEvent, ret = %{public}d", ret);
+        return E_SCREENLOCK_SENDREQUEST_FAILED;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t ScreenLockManagerProxy::UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    if (!data.WriteInterfaceToken(GetDescriptor())) {
+        SCLOCK_HILOGE(" Failed to write parcelable ");
+        return E_SCREENLOCK_WRITE_PARCEL_ERROR;
+    }
+    if (listener == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    if (!data.WriteRemoteObject(listener->AsObject().GetRefPtr())) {
+        SCLOCK_HILOGE("write parcel failed.");
+        return E_SCREENLOCK_WRITE_PARCEL_ERROR;
+    }
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::UNSUBSCRIBE_SYSTEM_EVENT), data, reply, option);
+    if (ret != ERR_NONE) {
+        SCLOCK_HILOGE("ScreenLockManagerProxy UnsubscribeSystemEvent, ret = %{public}d", ret);
+        return E_SCREENLOCK_SENDREQUEST_FAILED;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t ScreenLockManagerProxy::GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+    std::vector<SystemEvent> &events)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteUint64(epoch);
+    data.WriteUint64(lastSeq);
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::GET_MISSED_EVENTS), data, reply, option);
+    if (ret != ERR_NONE) {
+        SCLOCK_HILOGE("ScreenLockManagerProxy GetMissedEvents, ret = %{public}d", ret);
+        return E_SCREENLOCK_SENDREQUEST_FAILED;
+    }
+    int32_t retCode = reply.ReadInt32();
+    if (retCode != E_SCREENLOCK_OK) {
+        SCLOCK_HILOGE("GetMissedEvents, retCode = %{public}d", retCode);
+        return retCode;
+    }
+    resync.epoch = reply.ReadUint64();
+    resync.latestSeq = reply.ReadUint64();
+    resync.isFullSync = reply.ReadBool();
+    events.clear();
+    if (resync.isFullSync) {
+        resync.currentUser = reply.ReadInt32();
+        resync.screenState = reply.ReadInt32();
+        resync.interactiveState = reply.ReadInt32();
+        resync.snapshot.version = reply.ReadInt32();
+        resync.snapshot.isLocked = reply.ReadBool();
+        resync.snapshot.isSecure = reply.ReadBool();
+        resync.snapshot.isDisabled = reply.ReadBool();
+        resync.snapshot.authState = reply.ReadInt32();
+        resync.snapshot.strongAuthReason = reply.ReadInt32();
+        return E_SCREENLOCK_OK;
+    }
+    uint32_t count = reply.ReadUint32();
+    if (count > MAX_MISSED_EVENTS) {
+        SCLOCK_HILOGE("GetMissedEvents, invalid count = %{public}u", count);
+        return E_SCREENLOCK_READ_PARCEL_ERROR;
+    }
+    events.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto eventId = static_cast<SystemEventId>(reply.ReadInt32());
+        std::string params = reply.ReadString();
+        int32_t userId = reply.ReadInt32();
+        SystemEvent event(eventId, params, userId);
+        event.seq_ = reply.ReadUint64();
+        events.push_back(event);
+    }
+    return E_SCREENLOCK_OK;
+}
 } // namespace ScreenLock
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
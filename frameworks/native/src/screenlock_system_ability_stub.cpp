@@ -38,7 +38,22 @@ int32_t ScreenLockSystemAbilityStub::OnRemoteRequest(uint32_t code, MessageParce
     }
     switch (code) {
         case ON_CALLBACK: {
-            SystemEvent systemEvent(data.ReadString(), data.ReadString());
+            std::string eventType = data.ReadString();
+            std::string params = data.ReadString();
+            // The sequence number and event id are appended last so older services can still be decoded.
+            uint64_t seq = 0;
+            if (data.GetReadableBytes() >= sizeof(uint64_t)) {
+                seq = data.ReadUint64();
+            }
+            int32_t eventId = static_cast<int32_t>(SystemEventId::UNKNOWN);
+            if (data.GetReadableBytes() >= sizeof(int32_t)) {
+                eventId = data.ReadInt32();
+            }
+            // A known id skips the name lookup, the name is only decoded for senders without the id.
+            bool isKnownId = eventId > 0 && eventId < static_cast<int32_t>(SystemEventId::BUTT);
+            SystemEvent systemEvent = isKnownId ? SystemEvent(static_cast<SystemEventId>(eventId), params) :
+                SystemEvent(eventType, params);
+            systemEvent.seq_ = seq;
             OnCallBack(systemEvent);
             break;
         }
@@ -46,6 +46,59 @@ const std::string LOCK_SCREEN_RESULT = "lockScreenResult";
 const std::string SCREEN_DRAWDONE = "screenDrawDone";
 const std::string SYSTEM_READY = "systemReady";
 const std::string SERVICE_RESTART = "serviceRestart";
+
+// Compact id of a system event, sent over IPC next to the name. Values are part of the wire format,
+// append new ids before BUTT and never reorder them.
+enum class SystemEventId : int32_t {
+    UNKNOWN = 0,
+    BEGIN_WAKEUP,
+    END_WAKEUP,
+    BEGIN_SCREEN_ON,
+    END_SCREEN_ON,
+    BEGIN_SLEEP,
+    END_SLEEP,
+    BEGIN_SCREEN_OFF,
+    END_SCREEN_OFF,
+    STRONG_AUTH_CHANGED,
+    CHANGE_USER,
+    SCREENLOCK_ENABLED,
+    EXIT_ANIMATION,
+    UNLOCKSCREEN,
+    UNLOCK_SCREEN_RESULT,
+    LOCKSCREEN,
+    LOCK_SCREEN_RESULT,
+    SCREEN_DRAWDONE,
+    SYSTEM_READY,
+    SERVICE_RESTART,
+    BUTT,
+};
+
+inline const std::string &GetSystemEventName(SystemEventId eventId)
+{
+    // Indexed by SystemEventId, so keep the entries in enum order.
+    static const std::string names[] = { "", BEGIN_WAKEUP, END_WAKEUP, BEGIN_SCREEN_ON, END_SCREEN_ON, BEGIN_SLEEP,
+        END_SLEEP, BEGIN_SCREEN_OFF, END_SCREEN_OFF, STRONG_AUTH_CHANGED, CHANGE_USER, SCREENLOCK_ENABLED,
+        EXIT_ANIMATION, UNLOCKSCREEN, UNLOCK_SCREEN_RESULT, LOCKSCREEN, LOCK_SCREEN_RESULT, SCREEN_DRAWDONE,
+        SYSTEM_READY, SERVICE_RESTART };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(SystemEventId::BUTT),
+        "every SystemEventId needs a name");
+    int32_t index = static_cast<int32_t>(eventId);
+    if (index <= 0 || index >= static_cast<int32_t>(SystemEventId::BUTT)) {
+        return names[0];
+    }
+    return names[index];
+}
+
+inline SystemEventId GetSystemEventId(const std::string &eventType)
+{
+    for (int32_t index = 1; index < static_cast<int32_t>(SystemEventId::BUTT); index++) {
+        auto eventId = static_cast<SystemEventId>(index);
+        if (GetSystemEventName(eventId) == eventType) {
+            return eventId;
+        }
+    }
+    return SystemEventId::UNKNOWN;
+}
 const int USER_NULL = -10000;
 enum ScreenLockModule {
     SCREENLOCK_MODULE_SERVICE_ID = 0x04,
@@ -69,6 +122,7 @@ enum ScreenLockError {
     E_SCREENLOCK_SENDREQUEST_FAILED,
     E_SCREENLOCK_NOT_SYSTEM_APP,
     E_SCREENLOCK_NOT_FOCUS_APP,
+    E_SCREENLOCK_LISTENER_OVERFLOW,
 };
 
 enum TraceTaskId : int32_t {
@@ -106,6 +160,32 @@ enum class StrongAuthReasonFlags : int32_t {
     DPM_RESTRICT = 0x00000008,
 };
 
+constexpr int32_t STATE_SNAPSHOT_VERSION = 1;
+
+struct ScreenLockStateSnapshot {
+    int32_t version = STATE_SNAPSHOT_VERSION;
+    bool isLocked = false;
+    bool isSecure = false;
+    bool isDisabled = false;
+    int32_t authState = 0;
+    int32_t strongAuthReason = 0;
+};
+
+// Capacity of the service event history, and so the most events one resync can return.
+constexpr uint32_t MAX_MISSED_EVENTS = 128;
+
+struct ScreenLockEventResync {
+    // Service instance the sequence numbers belong to, it changes whenever the service restarts.
+    uint64_t epoch = 0;
+    uint64_t latestSeq = 0;
+    // The missed events are gone, the fields below carry the current state instead.
+    bool isFullSync = false;
+    int32_t currentUser = 0;
+    int32_t screenState = 0;
+    int32_t interactiveState = 0;
+    ScreenLockStateSnapshot snapshot;
+};
+
 constexpr int BEGIN_SLEEP_DEVICE_ADMIN_REASON = 1;
 constexpr int BEGIN_SLEEP_USER_REASON = 2;
 constexpr int BEGIN_SLEEP_LONG_TIME_UNOPERATOR = 3;
@@ -16,6 +16,8 @@
 #ifndef SERVICES_INCLUDE_SCLOCK_MANAGER_H
 #define SERVICES_INCLUDE_SCLOCK_MANAGER_H
 
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <string>
 
@@ -24,6 +26,7 @@
 #include "screenlock_callback_interface.h"
 #include "screenlock_common.h"
 #include "screenlock_manager_interface.h"
+#include "screenlock_shared_state.h"
 #include "visibility.h"
 
 namespace OHOS {
@@ -49,6 +52,14 @@ public:
 
     SCREENLOCK_API bool IsScreenLocked();
     SCREENLOCK_API bool GetSecure();
+
+    /**
+     * Enable or disable the local cache of the secure state.
+     * Cached values are dropped when the credential of any user changes or the service restarts.
+     *
+     * @param enable Indicates whether GetSecure may be answered from the cache.
+     */
+    SCREENLOCK_API void EnableStateCache(bool enable);
     SCREENLOCK_API int32_t Unlock(Action action, const sptr<ScreenLockCallbackInterface> &listener);
     SCREENLOCK_API int32_t RequestStrongAuth(int reasonFlag, int32_t userId);
     int32_t Lock(const sptr<ScreenLockCallbackInterface> &listener);
@@ -69,11 +80,29 @@ private:
     void OnRemoteSaDied(const wptr<IRemoteObject> &object);
     sptr<ScreenLockManagerInterface> GetProxy();
     sptr<ScreenLockManagerInterface> GetScreenLockManagerProxy();
+    bool ReadSharedState(SharedStateSnapshot &snapshot, bool &isLockQueryAllowed);
+    void ResetSharedState();
+    void ResetSecureCache();
     static std::mutex instanceLock_;
     static sptr<ScreenLockManager> instance_;
     sptr<ScreenLockSaDeathRecipient> deathRecipient_;
     std::mutex managerProxyLock_;
     sptr<ScreenLockManagerInterface> screenlockManagerProxy_;
+    std::mutex sharedStateLock_;
+    std::shared_ptr<ScreenLockSharedState> sharedState_;
+    bool isLockQueryAllowed_ = false;
+    // Next time a failed shared state request may be retried, and the delay that led to it.
+    std::chrono::steady_clock::time_point sharedStateRetryTime_;
+    std::chrono::milliseconds sharedStateRetryDelay_ { 0 };
+    struct SecureCache {
+        bool isValid = false;
+        bool isSecure = false;
+        int32_t currentUser = 0;
+        uint64_t credentialEpoch = 0;
+    };
+    std::atomic<bool> stateCacheEnabled_ = false;
+    std::mutex secureCacheLock_;
+    SecureCache secureCache_;
 };
 } // namespace ScreenLock
 } // namespace OHOS
@@ -17,7 +17,9 @@
 #define SERVICES_INCLUDE_SCLOCK_SERVICE_INTERFACE_H
 
 #include <string>
+#include <vector>
 
+#include "ashmem.h"
 #include "iremote_broker.h"
 #include "screenlock_callback_interface.h"
 #include "screenlock_common.h"
@@ -43,6 +45,13 @@ public:
     virtual int32_t GetScreenLockAuthState(int userId, int32_t &authState) = 0;
     virtual int32_t RequestStrongAuth(int reasonFlag, int32_t userId) = 0;
     virtual int32_t GetStrongAuth(int32_t userId, int32_t &reasonFlag) = 0;
+    virtual int32_t GetSharedState(sptr<Ashmem> &ashmem, bool &isLockQueryAllowed) = 0;
+    virtual int32_t GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot) = 0;
+    virtual int32_t SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+        const std::vector<std::string> &eventTypes) = 0;
+    virtual int32_t UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener) = 0;
+    virtual int32_t GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+        std::vector<SystemEvent> &events) = 0;
 };
 } // namespace ScreenLock
 } // namespace OHOS
@@ -18,6 +18,7 @@
 
 #include "iremote_broker.h"
 #include "iremote_object.h"
+#include "screenlock_common.h"
 
 namespace OHOS {
 namespace ScreenLock {
@@ -25,9 +26,21 @@ struct SystemEvent {
     std::string eventType_;
     std::string params_;
     int32_t userId_;
+    // Assigned by the service when the event is emitted, 0 when the sender is older than the field.
+    uint64_t seq_ = 0;
+    // The service builds events by id and leaves eventType_ empty; use GetEventType() for the name.
+    SystemEventId eventId_;
     explicit SystemEvent(std::string eventType = "", std::string params = "", int32_t userId = -1)
-        : eventType_(eventType), params_(params), userId_(userId)
+        : eventType_(eventType), params_(params), userId_(userId),
+          eventId_(eventType.empty() ? SystemEventId::UNKNOWN : GetSystemEventId(eventType))
     {}
+    explicit SystemEvent(SystemEventId eventId, std::string params = "", int32_t userId = -1)
+        : params_(params), userId_(userId), eventId_(eventId)
+    {}
+    const std::string &GetEventType() const
+    {
+        return eventId_ == SystemEventId::UNKNOWN ? eventType_ : GetSystemEventName(eventId_);
+    }
 };
 
 class ScreenLockSystemAbilityInterface : public IRemoteBroker {
@@ -33,6 +33,7 @@ class CommeventMgr {
 public:
     void SubscribeEvent();
     void UnSubscribeEvent();
+    bool IsSubscribed();
     void OnReceiveEvent(const AAFwk::Want &want);
 
 private:
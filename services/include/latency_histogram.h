@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_LATENCY_HISTOGRAM_H
+#define SCREENLOCK_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace ScreenLock {
+/**
+ * Lock-free latency histogram with power-of-two microsecond buckets.
+ * Bucket 0 counts samples below 1us, bucket i counts [2^(i-1), 2^i) us and the last bucket is open ended.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 24;
+
+    LatencyHistogram() = default;
+    ~LatencyHistogram() = default;
+
+    void Record(std::chrono::nanoseconds latency);
+    uint64_t GetCount() const;
+    uint64_t GetBucketCount(size_t bucket) const;
+    void Dump(const std::string &name, std::string &output) const;
+
+    static size_t GetBucket(uint64_t latencyUs);
+
+private:
+    uint64_t GetPercentileUs(uint64_t count, double percentile) const;
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_ {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> totalUs_ = 0;
+    std::atomic<uint64_t> maxUs_ = 0;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_LATENCY_HISTOGRAM_H
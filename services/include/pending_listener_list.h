@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_PENDING_LISTENER_LIST_H
+#define SCREENLOCK_PENDING_LISTENER_LIST_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "iremote_object.h"
+#include "latency_histogram.h"
+#include "refbase.h"
+#include "screenlock_callback_interface.h"
+
+namespace OHOS {
+namespace ScreenLock {
+/**
+ * Callbacks waiting for the result of a lock or unlock request.
+ * The list is bounded, and a callback whose process dies is removed at once instead of
+ * waiting for the next result. NotifyAll swaps the list out and hands every callback its own
+ * task, so one slow caller neither holds the list lock nor delays the others. Callbacks are one-way
+ * sends; results taking long to hand over are only counted as slow, no deadline is enforced.
+ * A callback added while the same caller has a request younger than staleAfter outstanding joins it instead
+ * of starting another one. Every pending callback receives the next result either way.
+ */
+class PendingListenerList {
+public:
+    PendingListenerList(const std::string &name, size_t capacity);
+    ~PendingListenerList() = default;
+
+    int32_t Add(const sptr<ScreenLockCallbackInterface> &listener);
+    int32_t Add(const sptr<ScreenLockCallbackInterface> &listener, uint32_t callerTokenId,
+        std::chrono::milliseconds staleAfter, bool &joined);
+    std::vector<sptr<ScreenLockCallbackInterface>> TakeAll();
+    size_t NotifyAll(int32_t result);
+    size_t Size();
+    void SetCapacity(size_t capacity);
+    void Dump(std::string &output);
+    void DumpLatency(std::string &output);
+
+private:
+    class ListenerDeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        explicit ListenerDeathRecipient(PendingListenerList &list) : list_(list) {}
+        ~ListenerDeathRecipient() override = default;
+        void OnRemoteDied(const wptr<IRemoteObject> &object) override;
+
+    private:
+        PendingListenerList &list_;
+    };
+
+    struct PendingListener {
+        sptr<ScreenLockCallbackInterface> listener;
+        std::chrono::steady_clock::time_point requestTime;
+        uint32_t callerTokenId = 0;
+        // False for the callback whose Add started the request the others joined.
+        bool joined = false;
+    };
+
+    std::vector<PendingListener> TakePending();
+    void Remove(const sptr<IRemoteObject> &remote);
+    void Notify(const PendingListener &pending, int32_t result, std::chrono::steady_clock::time_point notifyTime);
+
+    const std::string name_;
+    std::mutex listenerMutex_;
+    std::vector<PendingListener> listeners_;
+    size_t capacity_;
+    size_t peak_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t pruned_ = 0;
+    uint64_t joined_ = 0;
+    std::atomic<uint64_t> notified_{ 0 };
+    std::atomic<uint64_t> slow_{ 0 };
+    // From the lock/unlock request to its callback returning.
+    LatencyHistogram latency_;
+    sptr<ListenerDeathRecipient> deathRecipient_;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_PENDING_LISTENER_LIST_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_PERMISSION_CACHE_H
+#define SCREENLOCK_PERMISSION_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "access_token.h"
+#include "perm_state_change_callback_customize.h"
+#include "refbase.h"
+
+namespace OHOS {
+namespace ScreenLock {
+/**
+ * Bounded LRU cache of (tokenId, permission) verdicts.
+ * Entries are dropped by access token permission state change callbacks; while the
+ * callback is not registered every check goes to the access token service.
+ * Uninstalls and token id reuse raise no such callback, so every verdict also expires after a short TTL.
+ */
+class PermissionCache : public RefBase {
+public:
+    static sptr<PermissionCache> GetInstance();
+
+    PermissionCache() = default;
+    ~PermissionCache() override = default;
+
+    bool VerifyAccessToken(Security::AccessToken::AccessTokenID tokenId, const std::string &permissionName);
+    void RegisterPermStateChangeCallback();
+    void UnRegisterPermStateChangeCallback();
+    void Invalidate(Security::AccessToken::AccessTokenID tokenId, const std::string &permissionName);
+    void Clear();
+    void Dump(std::string &output);
+
+private:
+    class PermStateObserver : public Security::AccessToken::PermStateChangeCallbackCustomize {
+    public:
+        explicit PermStateObserver(const Security::AccessToken::PermStateChangeScope &scope)
+            : PermStateChangeCallbackCustomize(scope)
+        {}
+        ~PermStateObserver() override = default;
+        void PermStateChangeCallback(Security::AccessToken::PermStateChangeInfo &result) override;
+    };
+
+    using CacheKey = std::pair<Security::AccessToken::AccessTokenID, std::string>;
+    struct CacheEntry {
+        CacheKey key;
+        bool isGranted = false;
+        std::chrono::steady_clock::time_point expireTime;
+    };
+
+    static std::mutex instanceLock_;
+    static sptr<PermissionCache> instance_;
+    std::mutex observerMutex_;
+    std::mutex cacheMutex_;
+    uint64_t generation_ = 0;
+    std::list<CacheEntry> lruList_;
+    std::map<CacheKey, std::list<CacheEntry>::iterator> cacheMap_;
+    std::shared_ptr<PermStateObserver> observer_;
+    std::atomic<bool> isCacheEnabled_ = false;
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_PERMISSION_CACHE_H
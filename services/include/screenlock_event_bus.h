@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_EVENT_BUS_H
+#define SCREENLOCK_EVENT_BUS_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "iremote_object.h"
+#include "refbase.h"
+#include "screenlock_system_ability_interface.h"
+
+namespace OHOS {
+namespace ScreenLock {
+/**
+ * Fan-out of system events to any number of subscribers.
+ * Every subscriber has its own bounded queue drained by its own ffrt task, so a slow
+ * subscriber only delays itself. While a subscriber lags, a queued screen or interactive
+ * transition is replaced by the newer one of the same kind. Dead subscribers are removed
+ * by a death recipient. The latest MAX_MISSED_EVENTS events are kept in a history ring so a
+ * reconnecting client can fetch what it missed.
+ */
+class ScreenLockEventBus {
+public:
+    ScreenLockEventBus();
+    ~ScreenLockEventBus() = default;
+
+    int32_t Subscribe(const sptr<ScreenLockSystemAbilityInterface> &listener,
+        const std::vector<std::string> &eventTypes);
+    int32_t Unsubscribe(const sptr<ScreenLockSystemAbilityInterface> &listener);
+    // Assigns the next seq and records the event in the history under one lock, returns the seq.
+    uint64_t Publish(const SystemEvent &systemEvent);
+    uint64_t GetLatestSeq();
+    size_t GetSubscriberCount();
+    uint64_t GetEpoch() const;
+    bool GetEventsSince(uint64_t lastSeq, std::vector<SystemEvent> &events);
+    void Dump(std::string &output);
+    static bool Supersedes(const SystemEvent &newer, const SystemEvent &older);
+
+private:
+    class SubscriberDeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        explicit SubscriberDeathRecipient(ScreenLockEventBus &bus) : bus_(bus) {}
+        ~SubscriberDeathRecipient() override = default;
+        void OnRemoteDied(const wptr<IRemoteObject> &object) override;
+
+    private:
+        ScreenLockEventBus &bus_;
+    };
+
+    struct Subscriber {
+        sptr<ScreenLockSystemAbilityInterface> listener;
+        std::set<SystemEventId> eventIds;
+        std::deque<SystemEvent> pendingEvents;
+        bool isDelivering = false;
+        uint64_t delivered = 0;
+        uint64_t coalesced = 0;
+        uint64_t dropped = 0;
+    };
+
+    bool Accepts(const Subscriber &subscriber, const SystemEvent &systemEvent);
+    void Deliver(std::shared_ptr<Subscriber> subscriber);
+    void RemoveSubscriber(IRemoteObject *remote);
+
+    std::mutex subscriberMutex_;
+    std::map<IRemoteObject *, std::shared_ptr<Subscriber>> subscribers_;
+    sptr<SubscriberDeathRecipient> deathRecipient_;
+    const uint64_t epoch_;
+    std::mutex historyMutex_;
+    std::deque<SystemEvent> history_;
+    uint64_t latestSeq_ = 0;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_EVENT_BUS_H
@@ -16,25 +16,44 @@
 #ifndef SERVICES_INCLUDE_SCLOCK_SERVICE_STUB_H
 #define SERVICES_INCLUDE_SCLOCK_SERVICE_STUB_H
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <map>
+#include <string>
 
 #include "iremote_stub.h"
 #include "screenlock_manager_interface.h"
+#include "screenlock_server_ipc_interface_code.h"
 
 namespace OHOS {
 namespace ScreenLock {
 class ScreenLockManagerStub : public IRemoteStub<ScreenLockManagerInterface> {
     using handleFunc = int32_t (ScreenLockManagerStub::*)(MessageParcel &, MessageParcel &);
-    using HandleFuncMap = std::map<uint32_t, handleFunc>;
+    static constexpr size_t HANDLE_FUNC_COUNT =
+        static_cast<size_t>(ScreenLockServerIpcInterfaceCode::SCREENLOCK_IPC_CODE_BUTT);
+
+    struct HandleEntry {
+        handleFunc func = nullptr;
+        const char *name = "";
+    };
+    using HandleTable = std::array<HandleEntry, HANDLE_FUNC_COUNT>;
+
+    struct IpcCodeStats {
+        std::atomic<uint64_t> calls = 0;
+        std::atomic<uint64_t> errors = 0;
+        std::atomic<uint64_t> totalTimeNs = 0;
+    };
 
 public:
-    ScreenLockManagerStub();
+    ScreenLockManagerStub() = default;
     ~ScreenLockManagerStub() = default;
     int32_t OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
 
+protected:
+    void DumpIpcStats(std::string &output);
+
 private:
-    void InitHandleMap(void);
+    static constexpr HandleTable BuildHandleTable();
     int32_t OnIsLocked(MessageParcel &data, MessageParcel &reply);
     int32_t OnIsScreenLocked(MessageParcel &data, MessageParcel &reply);
     int32_t OnGetSecure(MessageParcel &data, MessageParcel &reply);
@@ -50,9 +69,16 @@ private:
     int32_t OnGetScreenLockAuthState(MessageParcel &data, MessageParcel &reply);
     int32_t OnRequestStrongAuth(MessageParcel &data, MessageParcel &reply);
     int32_t OnGetStrongAuth(MessageParcel &data, MessageParcel &reply);
+    int32_t OnGetSharedState(MessageParcel &data, MessageParcel &reply);
+    int32_t OnGetStateSnapshot(MessageParcel &data, MessageParcel &reply);
+    int32_t OnSubscribeSystemEvent(MessageParcel &data, MessageParcel &reply);
+    int32_t OnUnsubscribeSystemEvent(MessageParcel &data, MessageParcel &reply);
+    int32_t OnGetMissedEvents(MessageParcel &data, MessageParcel &reply);
+    static sptr<ScreenLockSystemAbilityInterface> ReadSystemEventListener(MessageParcel &data);
 
 private:
-    HandleFuncMap handleFuncMap;
+    static const HandleTable handleTable_;
+    std::array<IpcCodeStats, HANDLE_FUNC_COUNT> ipcStats_;
 };
 } // namespace ScreenLock
 } // namespace OHOS
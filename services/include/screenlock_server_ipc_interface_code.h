@@ -38,6 +38,14 @@ enum class ScreenLockServerIpcInterfaceCode {
     GET_SCREENLOCK_AUTHSTATE,
     REQUEST_STRONG_AUTHSTATE,
     GET_STRONG_AUTHSTATE,
+    GET_SHARED_STATE,
+    GET_STATE_SNAPSHOT,
+    SUBSCRIBE_SYSTEM_EVENT,
+    UNSUBSCRIBE_SYSTEM_EVENT,
+    GET_MISSED_EVENTS,
+
+    // keep last, number of codes
+    SCREENLOCK_IPC_CODE_BUTT,
 };
 } // namespace ScreenLock
 } // namespace OHOS
@@ -16,7 +16,11 @@
 #ifndef SERVICES_INCLUDE_SCLOCK_SERVICES_H
 #define SERVICES_INCLUDE_SCLOCK_SERVICES_H
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -25,13 +29,19 @@
 #include "event_handler.h"
 #include "ffrt.h"
 #include "iremote_object.h"
+#include "latency_histogram.h"
 #include "screenlock_callback_interface.h"
+#include "screenlock_event_bus.h"
 #include "screenlock_manager_stub.h"
 #include "screenlock_system_ability_interface.h"
 #include "system_ability.h"
 #include "visibility.h"
+#include "window_manager.h"
 #include "os_account_manager.h"
+#include "pending_listener_list.h"
 #include "preferences_util.h"
+#include "screenlock_shared_state.h"
+#include "screenlock_user_store.h"
 #include "os_account_subscribe_info.h"
 
 namespace OHOS {
@@ -43,10 +53,13 @@ public:
     ~StateValue(){};
 
     void Reset();
+    bool InitSharedState();
+    sptr<Ashmem> GetSharedStateAshmem();
 
     void SetScreenlocked(bool isScreenlocked)
     {
         isScreenlocked_ = isScreenlocked;
+        PublishSharedState();
     };
 
     void SetScreenlockEnabled(bool screenlockEnabled)
@@ -57,21 +70,42 @@ public:
     void SetScreenState(int32_t screenState)
     {
         screenState_ = screenState;
+        PublishSharedState();
     };
 
     void SetOffReason(int32_t offReason)
     {
         offReason_ = offReason;
+        PublishSharedState();
     };
 
     void SetCurrentUser(int32_t currentUser)
     {
         currentUser_ = currentUser;
+        PublishSharedState();
     };
 
     void SetInteractiveState(int32_t interactiveState)
     {
         interactiveState_ = interactiveState;
+        PublishSharedState();
+    };
+
+    void SetCredentialTracked(bool credentialTracked)
+    {
+        credentialTracked_ = credentialTracked;
+        PublishSharedState();
+    };
+
+    void BumpCredentialEpoch()
+    {
+        credentialEpoch_++;
+        PublishSharedState();
+    };
+
+    bool GetCredentialTracked()
+    {
+        return credentialTracked_;
     };
 
     bool GetScreenlockedState()
@@ -105,12 +139,18 @@ public:
     };
 
 private:
+    void PublishSharedState();
+
     std::atomic<bool> isScreenlocked_ { false };
     std::atomic<bool> screenlockEnabled_ { false };
     std::atomic<int32_t> offReason_ {0};
-    std::atomic<int32_t> currentUser_ {0};
+    std::atomic<int32_t> currentUser_ { USER_NULL };
     std::atomic<int32_t> screenState_ {0};
     std::atomic<int32_t> interactiveState_ {0};
+    std::atomic<bool> credentialTracked_ { false };
+    std::atomic<uint64_t> credentialEpoch_ {0};
+    std::mutex sharedStateMutex_;
+    std::shared_ptr<ScreenLockSharedState> sharedState_;
 };
 
 enum class ScreenState : int32_t {
@@ -158,11 +198,23 @@ public:
     int32_t GetScreenLockAuthState(int userId, int32_t &authState) override;
     int32_t RequestStrongAuth(int reasonFlag, int32_t userId) override;
     int32_t GetStrongAuth(int userId, int32_t &reasonFlag) override;
+    int32_t GetSharedState(sptr<Ashmem> &ashmem, bool &isLockQueryAllowed) override;
+    int32_t GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot) override;
+    int32_t SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+        const std::vector<std::string> &eventTypes) override;
+    int32_t UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener) override;
+    int32_t GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+        std::vector<SystemEvent> &events) override;
     int Dump(int fd, const std::vector<std::u16string> &args) override;
     void SetScreenlocked(bool isScreenlocked);
     void RegisterDisplayPowerEventListener(int32_t times);
     void ResetFfrtQueue();
     void StrongAuthChanged(int32_t userId, int32_t reasonFlag);
+    void OnCredentialUpdated(const std::string &userId);
+    bool GetUserDisabled(int32_t userId, bool &isDisabled);
+    bool SetUserDisabled(int32_t userId, bool isDisabled);
+    void InitUserState(int32_t userId);
+    void RemoveUserState(int32_t userId);
     int32_t Lock(int32_t userId) override;
     StateValue &GetState()
     {
@@ -173,6 +225,12 @@ public:
         void OnDisplayPowerEvent(Rosen::DisplayPowerEvent event, Rosen::EventStatus status) override;
     };
 
+    class ScreenLockFocusChangedListener : public Rosen::IFocusChangedListener {
+    public:
+        void OnFocused(const sptr<Rosen::FocusChangeInfo> &focusChangeInfo) override;
+        void OnUnfocused(const sptr<Rosen::FocusChangeInfo> &focusChangeInfo) override;
+    };
+
     class AccountSubscriber : public AccountSA::OsAccountSubscriber {
     public:
         explicit AccountSubscriber(const AccountSA::OsAccountSubscribeInfo &subscribeInfo);
@@ -184,10 +242,18 @@ public:
         int userId_{-1};
     };
 
+    class AccountRemovedSubscriber : public AccountSA::OsAccountSubscriber {
+    public:
+        explicit AccountRemovedSubscriber(const AccountSA::OsAccountSubscribeInfo &subscribeInfo);
+        ~AccountRemovedSubscriber() override = default;
+        void OnAccountsChanged(const int &id) override;
+    };
+
 protected:
     void OnStart() override;
     void OnStop() override;
     void OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
+    void OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
 
 private:
     void OnScreenOn(Rosen::EventStatus status);
@@ -196,38 +262,93 @@ private:
     void OnSleep(Rosen::EventStatus status);
     void OnExitAnimation();
     void OnSystemReady();
+    void TryNotifySystemReady();
     void RegisterDumpCommand();
     int32_t Init();
     void InitUserId();
+    void InitUserStore();
+    void PreloadUserDisabled();
+    bool UpdateUserState(int32_t userId, const std::function<void(UserStateRecord &)> &update);
+    void DumpUserStore(std::string &output);
     void InitServiceHandler();
     void LockScreenEvent(int stateResult);
     void UnlockScreenEvent(int stateResult);
     void SystemEventCallBack(const SystemEvent &systemEvent, TraceTaskId traceTaskId = HITRACE_BUTT);
+    void DeliverPendingSystemEvents();
+    static bool IsCriticalEvent(SystemEventId eventId);
+    void DumpLatency(std::string &output);
     int32_t UnlockInner(const sptr<ScreenLockCallbackInterface> &listener);
     void PublishEvent(const std::string &eventAction);
     bool IsAppInForeground(int32_t callingPid, uint32_t callingTokenId);
+    void RegisterFocusChangedListener();
+    void OnFocusChanged(int32_t pid, bool focused);
     bool IsSystemApp();
+    bool IsUserSecure(int32_t userId);
+    int32_t FillStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot);
     bool CheckPermission(const std::string &permissionName);
     void NotifyUnlockListener(const int32_t screenLockResult);
     void NotifyDisplayEvent(Rosen::DisplayEvent event);
+    void NotifyKeyguardDrawn();
 
     ServiceRunningState state_;
     static std::mutex instanceLock_;
     static sptr<ScreenLockSystemAbility> instance_;
     static std::shared_ptr<ffrt::queue> queue_;
     std::shared_ptr<AccountSubscriber> accountSubscriber_;
+    std::shared_ptr<AccountRemovedSubscriber> accountRemovedSubscriber_;
     std::mutex accountSubscriberMutex_;
     sptr<Rosen::IDisplayPowerEventListener> displayPowerEventListener_;
+    sptr<Rosen::IFocusChangedListener> focusChangedListener_;
+    std::atomic<int32_t> focusedPid_ = -1;
+    std::atomic<bool> focusCacheValid_ = false;
+    std::atomic<uint64_t> focusEventCount_ = 0;
     std::mutex listenerMutex_;
     sptr<ScreenLockSystemAbilityInterface> systemEventListener_;
-    std::mutex unlockListenerMutex_;
-    std::vector<sptr<ScreenLockCallbackInterface>> unlockVecListeners_;
-    std::mutex lockListenerMutex_;
-    std::vector<sptr<ScreenLockCallbackInterface>> lockVecListeners_;
+    ScreenLockEventBus eventBus_;
+    struct PendingSystemEvent {
+        SystemEvent systemEvent;
+        TraceTaskId traceTaskId = HITRACE_BUTT;
+        std::chrono::steady_clock::time_point ingressTime;
+    };
+    bool TakeNextSystemEvent(PendingSystemEvent &pending);
+    void DeliverSystemEvent(const PendingSystemEvent &pending);
+    struct EventLatency {
+        LatencyHistogram queueWait;
+        LatencyHistogram send;
+    };
+    std::array<EventLatency, static_cast<size_t>(SystemEventId::BUTT)> eventLatency_;
+    // steady_clock time of the last BEGIN_WAKEUP, consumed by the next keyguard drawn signal.
+    std::atomic<int64_t> wakeUpTimeNs_ = 0;
+    LatencyHistogram wakeToDrawn_;
+    LatencyHistogram keyguardDrawnNotify_;
+    std::mutex pendingEventMutex_;
+    // Events for the lock app, each kind in seq order. Critical events are taken first, so they wait behind
+    // at most the informational event already being sent; the lock app restores the full order from seq.
+    std::deque<PendingSystemEvent> pendingCriticalEvents_;
+    std::deque<PendingSystemEvent> pendingSystemEvents_;
+    ffrt::mutex deliveryMutex_;
+    std::atomic<uint64_t> coalescedEvents_ = 0;
+    PendingListenerList unlockListeners_;
+    PendingListenerList lockListeners_;
     StateValue stateValue_;
     std::atomic<bool> systemReady_ = false;
+    // SYSTEM_READY is owed to the registered listener once systemReady_ is also set.
+    std::mutex readinessMutex_;
+    bool systemReadyPending_ = false;
+    // Per-user disabled flag and auth hints, PreferencesUtil stands in when the store cannot be opened.
+    ScreenLockUserStore userStore_;
+    std::mutex userStateMutex_;
+    // Every user's disabled flag, loaded once and written through, so queries never reach the store.
+    // Writers are serialized by disabledWriteMutex_ and take disabledCacheMutex_ only to publish.
+    std::mutex disabledWriteMutex_;
+    std::mutex disabledCacheMutex_;
+    std::map<int32_t, bool> disabledCache_;
+    bool disabledCacheLoaded_ = false;
     std::map<int32_t, int32_t> authStateInfo;
     std::mutex authStateMutex_;
+    std::mutex secureCacheMutex_;
+    std::map<int32_t, bool> secureCache_;
+    uint64_t secureCacheGeneration_ = 0;
 };
 } // namespace ScreenLock
 } // namespace OHOS
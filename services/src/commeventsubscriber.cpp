@@ -16,7 +16,8 @@
 #include "commeventsubscriber.h"
 #include "sclock_log.h"
 #include "screenlock_common.h"
-#include "preferences_util.h"
+#include "screenlock_system_ability.h"
+#include "string_ex.h"
 
 namespace OHOS {
 namespace ScreenLock {
@@ -42,15 +43,15 @@ void CommeventMgr::OnReceiveEvent(const AAFwk::Want &want)
         std::string userId = want.GetStringParam(TAG_USERID);
         std::string authType = want.GetStringParam(TAG_AUTHTYPE);
         std::string credentialCount = want.GetStringParam(TAG_CREDENTIALCOUNT);
+        ScreenLockSystemAbility::GetInstance()->OnCredentialUpdated(userId);
         if (authType == AUTH_PIN && credentialCount != HAS_NO_CREDENTIAL) {
             SCLOCK_HILOGI("set passwd");
-            auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
-            if (preferencesUtil == nullptr) {
-                SCLOCK_HILOGE("preferencesUtil is nullptr!");
+            int32_t id = 0;
+            if (!StrToInt(userId, id)) {
+                SCLOCK_HILOGE("invalid userId");
                 return;
             }
-            preferencesUtil->RemoveKey(userId);
-            preferencesUtil->Refresh();
+            ScreenLockSystemAbility::GetInstance()->SetUserDisabled(id, false);
         }
     }
 }
@@ -77,6 +78,11 @@ void CommeventMgr::SubscribeEvent()
     return;
 }
 
+bool CommeventMgr::IsSubscribed()
+{
+    return subscriber_ != nullptr;
+}
+
 void CommeventMgr::UnSubscribeEvent()
 {
     if (subscriber_) {
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency_histogram.h"
+
+#include <cmath>
+
+namespace OHOS {
+namespace ScreenLock {
+namespace {
+constexpr double PERCENTILE_50 = 0.50;
+constexpr double PERCENTILE_99 = 0.99;
+constexpr uint32_t BITS_OF_UINT64 = 64;
+} // namespace
+
+size_t LatencyHistogram::GetBucket(uint64_t latencyUs)
+{
+    if (latencyUs == 0) {
+        return 0;
+    }
+    size_t bucket = BITS_OF_UINT64 - static_cast<size_t>(__builtin_clzll(latencyUs));
+    return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency)
+{
+    auto latencyCount = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    uint64_t latencyUs = latencyCount > 0 ? static_cast<uint64_t>(latencyCount) : 0;
+    buckets_[GetBucket(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+    uint64_t maxUs = maxUs_.load(std::memory_order_relaxed);
+    while (latencyUs > maxUs) {
+        if (maxUs_.compare_exchange_weak(maxUs, latencyUs, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetBucketCount(size_t bucket) const
+{
+    return bucket < BUCKET_COUNT ? buckets_[bucket].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t LatencyHistogram::GetPercentileUs(uint64_t count, double percentile) const
+{
+    // Reports the upper bound of the bucket holding the sample, the open-ended bucket reports the maximum.
+    uint64_t rank = static_cast<uint64_t>(std::ceil(count * percentile));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKET_COUNT - 1; bucket++) {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return 1ULL << bucket;
+        }
+    }
+    return maxUs_.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Dump(const std::string &name, std::string &output) const
+{
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return;
+    }
+    output.append(" * " + name)
+        .append("\tcount:" + std::to_string(count))
+        .append("\tavg(us):" + std::to_string(totalUs_.load(std::memory_order_relaxed) / count))
+        .append("\tp50(us):<=" + std::to_string(GetPercentileUs(count, PERCENTILE_50)))
+        .append("\tp99(us):<=" + std::to_string(GetPercentileUs(count, PERCENTILE_99)))
+        .append("\tmax(us):" + std::to_string(maxUs_.load(std::memory_order_relaxed)) + "\n   ");
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        uint64_t bucketCount = buckets_[bucket].load(std::memory_order_relaxed);
+        if (bucketCount == 0) {
+            continue;
+        }
+        std::string bound = bucket == BUCKET_COUNT - 1 ? ">=" + std::to_string(1ULL << (bucket - 1))
+                                                        : "<" + std::to_string(1ULL << bucket);
+        output.append(" " + bound + "us:" + std::to_string(bucketCount));
+    }
+    output.append("\n");
+}
+} // namespace ScreenLock
+} // namespace OHOS
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pending_listener_list.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "ffrt.h"
+#include "sclock_log.h"
+#include "screenlock_common.h"
+
+namespace OHOS {
+namespace ScreenLock {
+namespace {
+// Handing a result over taking longer than this is logged and counted as slow. It is a latency
+// threshold, not a deadline: the callback is a one-way send, so a stuck caller cannot hold the task.
+constexpr std::chrono::milliseconds NOTIFY_SLOW_THRESHOLD(500);
+} // namespace
+
+PendingListenerList::PendingListenerList(const std::string &name, size_t capacity)
+    : name_(name), capacity_(capacity)
+{
+    deathRecipient_ = new ListenerDeathRecipient(*this);
+}
+
+int32_t PendingListenerList::Add(const sptr<ScreenLockCallbackInterface> &listener)
+{
+    bool joined = false;
+    return Add(listener, 0, std::chrono::milliseconds(0), joined);
+}
+
+int32_t PendingListenerList::Add(const sptr<ScreenLockCallbackInterface> &listener, uint32_t callerTokenId,
+    std::chrono::milliseconds staleAfter, bool &joined)
+{
+    joined = false;
+    if (listener == nullptr) {
+        SCLOCK_HILOGE("%{public}s listener is nullptr", name_.c_str());
+        return E_SCREENLOCK_NULLPTR;
+    }
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    if (listeners_.size() >= capacity_) {
+        rejected_++;
+        SCLOCK_HILOGE("%{public}s listeners overflow, capacity = %{public}zu", name_.c_str(), capacity_);
+        return E_SCREENLOCK_LISTENER_OVERFLOW;
+    }
+    sptr<IRemoteObject> remote = listener->AsObject();
+    if (remote != nullptr && remote->IsProxyObject()) {
+        remote->AddDeathRecipient(deathRecipient_);
+    }
+    auto now = std::chrono::steady_clock::now();
+    joined = std::any_of(listeners_.begin(), listeners_.end(),
+        [callerTokenId, staleAfter, now](const PendingListener &pending) {
+            return !pending.joined && pending.callerTokenId == callerTokenId && now - pending.requestTime < staleAfter;
+        });
+    if (joined) {
+        joined_++;
+    }
+    listeners_.push_back({ listener, now, callerTokenId, joined });
+    peak_ = std::max(peak_, listeners_.size());
+    return E_SCREENLOCK_OK;
+}
+
+std::vector<sptr<ScreenLockCallbackInterface>> PendingListenerList::TakeAll()
+{
+    std::vector<sptr<ScreenLockCallbackInterface>> listeners;
+    for (auto &pending : TakePending()) {
+        listeners.push_back(pending.listener);
+    }
+    return listeners;
+}
+
+std::vector<PendingListenerList::PendingListener> PendingListenerList::TakePending()
+{
+    std::vector<PendingListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        listeners.swap(listeners_);
+    }
+    for (auto &pending : listeners) {
+        sptr<IRemoteObject> remote = pending.listener->AsObject();
+        if (remote != nullptr && remote->IsProxyObject()) {
+            remote->RemoveDeathRecipient(deathRecipient_);
+        }
+    }
+    return listeners;
+}
+
+size_t PendingListenerList::NotifyAll(int32_t result)
+{
+    auto notifyTime = std::chrono::steady_clock::now();
+    auto listeners = TakePending();
+    for (auto &pending : listeners) {
+        ffrt::submit([this, pending, result, notifyTime]() { Notify(pending, result, notifyTime); }, {}, {},
+            ffrt::task_attr().qos(ffrt::qos_user_initiated));
+    }
+    return listeners.size();
+}
+
+void PendingListenerList::Notify(const PendingListener &pending, int32_t result,
+    std::chrono::steady_clock::time_point notifyTime)
+{
+    pending.listener->OnCallBack(result);
+    notified_++;
+    auto now = std::chrono::steady_clock::now();
+    latency_.Record(now - pending.requestTime);
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(now - notifyTime);
+    if (cost > NOTIFY_SLOW_THRESHOLD) {
+        slow_++;
+        SCLOCK_HILOGW("%{public}s listener notified slowly, result = %{public}d, cost = %{public}" PRId64 " ms",
+            name_.c_str(), result, static_cast<int64_t>(cost.count()));
+    }
+}
+
+size_t PendingListenerList::Size()
+{
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    return listeners_.size();
+}
+
+void PendingListenerList::SetCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    capacity_ = capacity;
+}
+
+void PendingListenerList::Dump(std::string &output)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    output.append(" * " + name_ + " listeners\t\t" + std::to_string(listeners_.size()))
+        .append("\tcapacity:" + std::to_string(capacity_))
+        .append("\tpeak:" + std::to_string(peak_))
+        .append("\trejected:" + std::to_string(rejected_))
+        .append("\tpruned:" + std::to_string(pruned_))
+        .append("\tjoined:" + std::to_string(joined_))
+        .append("\tnotified:" + std::to_string(notified_.load()))
+        .append("\tslow:" + std::to_string(slow_.load()) + "\n");
+}
+
+void PendingListenerList::DumpLatency(std::string &output)
+{
+    latency_.Dump(name_ + " request to result", output);
+}
+
+void PendingListenerList::Remove(const sptr<IRemoteObject> &remote)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    size_t count = listeners_.size();
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+        [&remote](const PendingListener &pending) { return pending.listener->AsObject() == remote; }),
+        listeners_.end());
+    pruned_ += count - listeners_.size();
+}
+
+void PendingListenerList::ListenerDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
+{
+    sptr<IRemoteObject> remote = object.promote();
+    if (remote == nullptr) {
+        return;
+    }
+    SCLOCK_HILOGW("pending listener died");
+    list_.Remove(remote);
+}
+} // namespace ScreenLock
+} // namespace OHOS
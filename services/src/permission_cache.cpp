@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "permission_cache.h"
+
+#include <vector>
+
+#include "accesstoken_kit.h"
+#include "sclock_log.h"
+
+namespace OHOS {
+namespace ScreenLock {
+using namespace OHOS::Security::AccessToken;
+std::mutex PermissionCache::instanceLock_;
+sptr<PermissionCache> PermissionCache::instance_;
+namespace {
+constexpr size_t MAX_CACHE_SIZE = 128;
+// Bounds how long a verdict outlives an event the state change callback does not report.
+constexpr std::chrono::seconds CACHE_ENTRY_TTL(5);
+const std::vector<std::string> WATCHED_PERMISSIONS = {
+    "ohos.permission.ACCESS_SCREEN_LOCK",
+    "ohos.permission.ACCESS_SCREEN_LOCK_INNER",
+};
+} // namespace
+
+sptr<PermissionCache> PermissionCache::GetInstance()
+{
+    if (instance_ == nullptr) {
+        std::lock_guard<std::mutex> autoLock(instanceLock_);
+        if (instance_ == nullptr) {
+            instance_ = new PermissionCache;
+        }
+    }
+    return instance_;
+}
+
+bool PermissionCache::VerifyAccessToken(AccessTokenID tokenId, const std::string &permissionName)
+{
+    CacheKey key(tokenId, permissionName);
+    uint64_t generation = 0;
+    if (isCacheEnabled_) {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        generation = generation_;
+        auto iter = cacheMap_.find(key);
+        if (iter != cacheMap_.end() && iter->second->expireTime <= std::chrono::steady_clock::now()) {
+            lruList_.erase(iter->second);
+            cacheMap_.erase(iter);
+        } else if (iter != cacheMap_.end()) {
+            lruList_.splice(lruList_.begin(), lruList_, iter->second);
+            hits_++;
+            return iter->second->isGranted;
+        }
+    }
+    misses_++;
+    bool isGranted = AccessTokenKit::VerifyAccessToken(tokenId, permissionName) == PERMISSION_GRANTED;
+    if (!isCacheEnabled_) {
+        return isGranted;
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    // A state change during the lookup may have made the verdict stale.
+    if (generation != generation_ || cacheMap_.find(key) != cacheMap_.end()) {
+        return isGranted;
+    }
+    lruList_.push_front({ key, isGranted, std::chrono::steady_clock::now() + CACHE_ENTRY_TTL });
+    cacheMap_[key] = lruList_.begin();
+    if (lruList_.size() > MAX_CACHE_SIZE) {
+        cacheMap_.erase(lruList_.back().key);
+        lruList_.pop_back();
+    }
+    return isGranted;
+}
+
+void PermissionCache::RegisterPermStateChangeCallback()
+{
+    std::lock_guard<std::mutex> autoLock(observerMutex_);
+    if (observer_ != nullptr) {
+        return;
+    }
+    PermStateChangeScope scope;
+    scope.permList = WATCHED_PERMISSIONS;
+    auto observer = std::make_shared<PermStateObserver>(scope);
+    int32_t ret = AccessTokenKit::RegisterPermStateChangeCallback(observer);
+    if (ret != RET_SUCCESS) {
+        SCLOCK_HILOGE("RegisterPermStateChangeCallback failed, ret = %{public}d", ret);
+        return;
+    }
+    observer_ = observer;
+    Clear();
+    isCacheEnabled_ = true;
+    SCLOCK_HILOGI("permission cache enabled");
+}
+
+void PermissionCache::UnRegisterPermStateChangeCallback()
+{
+    std::lock_guard<std::mutex> autoLock(observerMutex_);
+    isCacheEnabled_ = false;
+    Clear();
+    if (observer_ == nullptr) {
+        return;
+    }
+    int32_t ret = AccessTokenKit::UnRegisterPermStateChangeCallback(observer_);
+    SCLOCK_HILOGI("UnRegisterPermStateChangeCallback ret = %{public}d", ret);
+    observer_ = nullptr;
+}
+
+void PermissionCache::Invalidate(AccessTokenID tokenId, const std::string &permissionName)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    generation_++;
+    auto iter = cacheMap_.find(CacheKey(tokenId, permissionName));
+    if (iter == cacheMap_.end()) {
+        return;
+    }
+    lruList_.erase(iter->second);
+    cacheMap_.erase(iter);
+}
+
+void PermissionCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    generation_++;
+    lruList_.clear();
+    cacheMap_.clear();
+}
+
+void PermissionCache::Dump(std::string &output)
+{
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        size = lruList_.size();
+    }
+    output.append("\n Permission cache\t\tValue\n")
+        .append(" * enabled\t\t\t" + std::string(isCacheEnabled_ ? "true" : "false") + "\n")
+        .append(" * size\t\t\t\t" + std::to_string(size) + "\n")
+        .append(" * hits\t\t\t\t" + std::to_string(hits_.load()) + "\n")
+        .append(" * misses\t\t\t" + std::to_string(misses_.load()) + "\n");
+}
+
+void PermissionCache::PermStateObserver::PermStateChangeCallback(PermStateChangeInfo &result)
+{
+    SCLOCK_HILOGI("permission state changed, tokenId = %{public}u", result.tokenID);
+    PermissionCache::GetInstance()->Invalidate(result.tokenID, result.permissionName);
+}
+} // namespace ScreenLock
+} // namespace OHOS
@@ -29,7 +29,7 @@ void ScreenLockCallbackProxy::OnCallBack(int32_t screenLockResult)
     SCLOCK_HILOGD("ScreenLockCallbackProxy::OnCallBack  screenLockResult Start");
     MessageParcel data;
     MessageParcel reply;
-    MessageOption option;
+    MessageOption option(MessageOption::TF_ASYNC);
     if (!data.WriteInterfaceToken(GetDescriptor())) {
         SCLOCK_HILOGE("write descriptor failed");
         return;
@@ -40,7 +40,8 @@ void ScreenLockCallbackProxy::OnCallBack(int32_t screenLockResult)
     }
     int32_t errorCode = Remote()->SendRequest(ON_CALLBACK, data, reply, option);
     if (errorCode != 0) {
-        SCLOCK_HILOGE("SendRequest failed, errorCode: %{public}d", errorCode);
+        SCLOCK_HILOGE("SendRequest failed, errorCode: %{public}d, isDead: %{public}d", errorCode,
+            Remote()->IsObjectDead());
     }
 }
 } // namespace ScreenLock
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "screenlock_event_bus.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ffrt.h"
+#include "sclock_log.h"
+#include "screenlock_common.h"
+
+namespace OHOS {
+namespace ScreenLock {
+namespace {
+constexpr size_t MAX_SUBSCRIBERS = 16;
+constexpr size_t MAX_PENDING_EVENTS = 64;
+
+enum class TransitionKind : int32_t {
+    NONE,
+    SCREEN,
+    INTERACTIVE,
+};
+
+TransitionKind GetTransitionKind(SystemEventId eventId)
+{
+    switch (eventId) {
+        case SystemEventId::BEGIN_SCREEN_ON:
+        case SystemEventId::END_SCREEN_ON:
+        case SystemEventId::BEGIN_SCREEN_OFF:
+        case SystemEventId::END_SCREEN_OFF:
+            return TransitionKind::SCREEN;
+        case SystemEventId::BEGIN_WAKEUP:
+        case SystemEventId::END_WAKEUP:
+        case SystemEventId::BEGIN_SLEEP:
+        case SystemEventId::END_SLEEP:
+            return TransitionKind::INTERACTIVE;
+        default:
+            return TransitionKind::NONE;
+    }
+}
+
+bool IsLockEvent(SystemEventId eventId)
+{
+    return eventId == SystemEventId::LOCKSCREEN || eventId == SystemEventId::UNLOCKSCREEN ||
+        eventId == SystemEventId::LOCK_SCREEN_RESULT || eventId == SystemEventId::UNLOCK_SCREEN_RESULT;
+}
+
+// Unknown names map to SystemEventId::UNKNOWN, which is never published, so the filter stays non-empty.
+std::set<SystemEventId> ToEventIds(const std::vector<std::string> &eventTypes)
+{
+    std::set<SystemEventId> eventIds;
+    for (const auto &eventType : eventTypes) {
+        eventIds.insert(GetSystemEventId(eventType));
+    }
+    return eventIds;
+}
+} // namespace
+
+ScreenLockEventBus::ScreenLockEventBus()
+    : epoch_(static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()))
+{
+    deathRecipient_ = new SubscriberDeathRecipient(*this);
+}
+
+int32_t ScreenLockEventBus::Subscribe(const sptr<ScreenLockSystemAbilityInterface> &listener,
+    const std::vector<std::string> &eventTypes)
+{
+    if (listener == nullptr || listener->AsObject() == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    sptr<IRemoteObject> remote = listener->AsObject();
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    auto iter = subscribers_.find(remote.GetRefPtr());
+    if (iter != subscribers_.end()) {
+        iter->second->eventIds = ToEventIds(eventTypes);
+        SCLOCK_HILOGI("update subscriber, types = %{public}zu", eventTypes.size());
+        return E_SCREENLOCK_OK;
+    }
+    if (subscribers_.size() >= MAX_SUBSCRIBERS) {
+        SCLOCK_HILOGE("too many subscribers");
+        return E_SCREENLOCK_PARAMETERS_INVALID;
+    }
+    if (remote->IsProxyObject() && !remote->AddDeathRecipient(deathRecipient_)) {
+        SCLOCK_HILOGE("add death recipient failed");
+        return E_SCREENLOCK_DEAL_FAILED;
+    }
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->listener = listener;
+    subscriber->eventIds = ToEventIds(eventTypes);
+    subscribers_.emplace(remote.GetRefPtr(), subscriber);
+    SCLOCK_HILOGI("add subscriber, count = %{public}zu", subscribers_.size());
+    return E_SCREENLOCK_OK;
+}
+
+int32_t ScreenLockEventBus::Unsubscribe(const sptr<ScreenLockSystemAbilityInterface> &listener)
+{
+    if (listener == nullptr || listener->AsObject() == nullptr) {
+        SCLOCK_HILOGE("listener is nullptr");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    sptr<IRemoteObject> remote = listener->AsObject();
+    if (remote->IsProxyObject()) {
+        remote->RemoveDeathRecipient(deathRecipient_);
+    }
+    RemoveSubscriber(remote.GetRefPtr());
+    return E_SCREENLOCK_OK;
+}
+
+uint64_t ScreenLockEventBus::Publish(const SystemEvent &publishedEvent)
+{
+    SystemEvent systemEvent = publishedEvent;
+    std::vector<std::shared_ptr<Subscriber>> readySubscribers;
+    {
+        // Publishers run on any thread. Seq, history and subscriber queues are updated under the same
+        // locks, so every one of them stays in seq order.
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        {
+            std::lock_guard<std::mutex> historyLock(historyMutex_);
+            systemEvent.seq_ = ++latestSeq_;
+            if (history_.size() >= MAX_MISSED_EVENTS) {
+                history_.pop_front();
+            }
+            history_.push_back(systemEvent);
+        }
+        for (auto &[remote, subscriber] : subscribers_) {
+            if (!Accepts(*subscriber, systemEvent)) {
+                continue;
+            }
+            auto &pendingEvents = subscriber->pendingEvents;
+            size_t pendingCount = pendingEvents.size();
+            pendingEvents.erase(std::remove_if(pendingEvents.begin(), pendingEvents.end(),
+                [&systemEvent](const SystemEvent &pending) { return Supersedes(systemEvent, pending); }),
+                pendingEvents.end());
+            subscriber->coalesced += pendingCount - pendingEvents.size();
+            if (pendingEvents.size() >= MAX_PENDING_EVENTS) {
+                // Lock and unlock events are never dropped, the queue may outgrow the bound for them.
+                auto iter = std::find_if(pendingEvents.begin(), pendingEvents.end(),
+                    [](const SystemEvent &pending) { return !IsLockEvent(pending.eventId_); });
+                if (iter != pendingEvents.end()) {
+                    pendingEvents.erase(iter);
+                    subscriber->dropped++;
+                }
+            }
+            pendingEvents.push_back(systemEvent);
+            if (!subscriber->isDelivering) {
+                subscriber->isDelivering = true;
+                readySubscribers.push_back(subscriber);
+            }
+        }
+    }
+    for (auto &subscriber : readySubscribers) {
+        ffrt::submit([this, subscriber]() { Deliver(subscriber); }, {}, {}, ffrt::task_attr().qos(ffrt::qos_default));
+    }
+    return systemEvent.seq_;
+}
+
+size_t ScreenLockEventBus::GetSubscriberCount()
+{
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    return subscribers_.size();
+}
+
+uint64_t ScreenLockEventBus::GetLatestSeq()
+{
+    std::lock_guard<std::mutex> lock(historyMutex_);
+    return latestSeq_;
+}
+
+uint64_t ScreenLockEventBus::GetEpoch() const
+{
+    return epoch_;
+}
+
+bool ScreenLockEventBus::GetEventsSince(uint64_t lastSeq, std::vector<SystemEvent> &events)
+{
+    std::lock_guard<std::mutex> lock(historyMutex_);
+    if (history_.empty()) {
+        return lastSeq == 0;
+    }
+    // Either the ring rolled over past lastSeq, or lastSeq was never issued by this instance.
+    if (history_.front().seq_ > lastSeq + 1 || history_.back().seq_ < lastSeq) {
+        return false;
+    }
+    for (const auto &event : history_) {
+        if (event.seq_ > lastSeq) {
+            events.push_back(event);
+        }
+    }
+    return true;
+}
+
+void ScreenLockEventBus::Dump(std::string &output)
+{
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    output.append("\n System event subscribers\t" + std::to_string(subscribers_.size()) + "\n");
+    {
+        std::lock_guard<std::mutex> historyLock(historyMutex_);
+        output.append(" * epoch\t\t\t\t" + std::to_string(epoch_) + "\n")
+            .append(" * history\t\t\t" + std::to_string(history_.size()) + "\n");
+    }
+    size_t index = 0;
+    for (auto &[remote, subscriber] : subscribers_) {
+        output.append(" * subscriber " + std::to_string(index++))
+            .append("\ttypes:" + std::to_string(subscriber->eventIds.size()))
+            .append("\tpending:" + std::to_string(subscriber->pendingEvents.size()))
+            .append("\tdelivered:" + std::to_string(subscriber->delivered))
+            .append("\tcoalesced:" + std::to_string(subscriber->coalesced))
+            .append("\tdropped:" + std::to_string(subscriber->dropped) + "\n");
+    }
+}
+
+bool ScreenLockEventBus::Supersedes(const SystemEvent &newer, const SystemEvent &older)
+{
+    TransitionKind kind = GetTransitionKind(newer.eventId_);
+    return kind != TransitionKind::NONE && kind == GetTransitionKind(older.eventId_);
+}
+
+bool ScreenLockEventBus::Accepts(const Subscriber &subscriber, const SystemEvent &systemEvent)
+{
+    return subscriber.eventIds.empty() || subscriber.eventIds.count(systemEvent.eventId_) != 0;
+}
+
+void ScreenLockEventBus::Deliver(std::shared_ptr<Subscriber> subscriber)
+{
+    while (true) {
+        SystemEvent systemEvent;
+        {
+            std::lock_guard<std::mutex> lock(subscriberMutex_);
+            if (subscriber->pendingEvents.empty()) {
+                subscriber->isDelivering = false;
+                return;
+            }
+            systemEvent = subscriber->pendingEvents.front();
+            subscriber->pendingEvents.pop_front();
+            subscriber->delivered++;
+        }
+        subscriber->listener->OnCallBack(systemEvent);
+    }
+}
+
+void ScreenLockEventBus::RemoveSubscriber(IRemoteObject *remote)
+{
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    auto iter = subscribers_.find(remote);
+    if (iter == subscribers_.end()) {
+        return;
+    }
+    // A running delivery task keeps its own reference and ends once the queue is empty.
+    iter->second->pendingEvents.clear();
+    subscribers_.erase(iter);
+    SCLOCK_HILOGI("remove subscriber, count = %{public}zu", subscribers_.size());
+}
+
+void ScreenLockEventBus::SubscriberDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
+{
+    sptr<IRemoteObject> remote = object.promote();
+    if (remote == nullptr) {
+        return;
+    }
+    SCLOCK_HILOGW("subscriber died");
+    bus_.RemoveSubscriber(remote.GetRefPtr());
+}
+} // namespace ScreenLock
+} // namespace OHOS
@@ -15,6 +15,7 @@
 
 #include "screenlock_manager_stub.h"
 
+#include <chrono>
 #include <string>
 
 #include "ipc_skeleton.h"
@@ -28,43 +29,52 @@
 namespace OHOS {
 namespace ScreenLock {
 using namespace OHOS::HiviewDFX;
-ScreenLockManagerStub::ScreenLockManagerStub()
-{
-    InitHandleMap();
-}
 
-void ScreenLockManagerStub::InitHandleMap()
+constexpr ScreenLockManagerStub::HandleTable ScreenLockManagerStub::BuildHandleTable()
 {
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::IS_LOCKED)] =
-        &ScreenLockManagerStub::OnIsLocked;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::IS_SCREEN_LOCKED)] =
-        &ScreenLockManagerStub::OnIsScreenLocked;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::IS_SECURE_MODE)] =
-        &ScreenLockManagerStub::OnGetSecure;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::UNLOCK)] = &ScreenLockManagerStub::OnUnlock;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::UNLOCK_SCREEN)] =
-        &ScreenLockManagerStub::OnUnlockScreen;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::LOCK)] = &ScreenLockManagerStub::OnLock;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::SEND_SCREENLOCK_EVENT)] =
-        &ScreenLockManagerStub::OnSendScreenLockEvent;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::ONSYSTEMEVENT)] =
-        &ScreenLockManagerStub::OnScreenLockOn;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::LOCK_SCREEN)] =
-        &ScreenLockManagerStub::OnLockScreen;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::IS_SCREENLOCK_DISABLED)] =
-        &ScreenLockManagerStub::OnIsScreenLockDisabled;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::SET_SCREENLOCK_DISABLED)] =
-        &ScreenLockManagerStub::OnSetScreenLockDisabled;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::SET_SCREENLOCK_AUTHSTATE)] =
-        &ScreenLockManagerStub::OnSetScreenLockAuthState;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::GET_SCREENLOCK_AUTHSTATE)] =
-        &ScreenLockManagerStub::OnGetScreenLockAuthState;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::REQUEST_STRONG_AUTHSTATE)] =
-        &ScreenLockManagerStub::OnRequestStrongAuth;
-    handleFuncMap[static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::GET_STRONG_AUTHSTATE)] =
-        &ScreenLockManagerStub::OnGetStrongAuth;
+    HandleTable table {};
+    auto add = [&table](ScreenLockServerIpcInterfaceCode code, handleFunc func, const char *name) {
+        table[static_cast<size_t>(code)] = HandleEntry { func, name };
+    };
+    add(ScreenLockServerIpcInterfaceCode::IS_SCREEN_LOCKED, &ScreenLockManagerStub::OnIsScreenLocked,
+        "IS_SCREEN_LOCKED");
+    add(ScreenLockServerIpcInterfaceCode::IS_SECURE_MODE, &ScreenLockManagerStub::OnGetSecure, "IS_SECURE_MODE");
+    add(ScreenLockServerIpcInterfaceCode::UNLOCK_SCREEN, &ScreenLockManagerStub::OnUnlockScreen, "UNLOCK_SCREEN");
+    add(ScreenLockServerIpcInterfaceCode::ONSYSTEMEVENT, &ScreenLockManagerStub::OnScreenLockOn, "ONSYSTEMEVENT");
+    add(ScreenLockServerIpcInterfaceCode::LOCK, &ScreenLockManagerStub::OnLock, "LOCK");
+    add(ScreenLockServerIpcInterfaceCode::SEND_SCREENLOCK_EVENT, &ScreenLockManagerStub::OnSendScreenLockEvent,
+        "SEND_SCREENLOCK_EVENT");
+    add(ScreenLockServerIpcInterfaceCode::IS_LOCKED, &ScreenLockManagerStub::OnIsLocked, "IS_LOCKED");
+    add(ScreenLockServerIpcInterfaceCode::UNLOCK, &ScreenLockManagerStub::OnUnlock, "UNLOCK");
+    add(ScreenLockServerIpcInterfaceCode::LOCK_SCREEN, &ScreenLockManagerStub::OnLockScreen, "LOCK_SCREEN");
+    add(ScreenLockServerIpcInterfaceCode::IS_SCREENLOCK_DISABLED, &ScreenLockManagerStub::OnIsScreenLockDisabled,
+        "IS_SCREENLOCK_DISABLED");
+    add(ScreenLockServerIpcInterfaceCode::SET_SCREENLOCK_DISABLED, &ScreenLockManagerStub::OnSetScreenLockDisabled,
+        "SET_SCREENLOCK_DISABLED");
+    add(ScreenLockServerIpcInterfaceCode::SET_SCREENLOCK_AUTHSTATE, &ScreenLockManagerStub::OnSetScreenLockAuthState,
+        "SET_SCREENLOCK_AUTHSTATE");
+    add(ScreenLockServerIpcInterfaceCode::GET_SCREENLOCK_AUTHSTATE, &ScreenLockManagerStub::OnGetScreenLockAuthState,
+        "GET_SCREENLOCK_AUTHSTATE");
+    add(ScreenLockServerIpcInterfaceCode::REQUEST_STRONG_AUTHSTATE, &ScreenLockManagerStub::OnRequestStrongAuth,
+        "REQUEST_STRONG_AUTHSTATE");
+    add(ScreenLockServerIpcInterfaceCode::GET_STRONG_AUTHSTATE, &ScreenLockManagerStub::OnGetStrongAuth,
+        "GET_STRONG_AUTHSTATE");
+    add(ScreenLockServerIpcInterfaceCode::GET_SHARED_STATE, &ScreenLockManagerStub::OnGetSharedState,
+        "GET_SHARED_STATE");
+    add(ScreenLockServerIpcInterfaceCode::GET_STATE_SNAPSHOT, &ScreenLockManagerStub::OnGetStateSnapshot,
+        "GET_STATE_SNAPSHOT");
+    add(ScreenLockServerIpcInterfaceCode::SUBSCRIBE_SYSTEM_EVENT, &ScreenLockManagerStub::OnSubscribeSystemEvent,
+        "SUBSCRIBE_SYSTEM_EVENT");
+    add(ScreenLockServerIpcInterfaceCode::UNSUBSCRIBE_SYSTEM_EVENT, &ScreenLockManagerStub::OnUnsubscribeSystemEvent,
+        "UNSUBSCRIBE_SYSTEM_EVENT");
+    add(ScreenLockServerIpcInterfaceCode::GET_MISSED_EVENTS, &ScreenLockManagerStub::OnGetMissedEvents,
+        "GET_MISSED_EVENTS");
+    return table;
 }
 
+const ScreenLockManagerStub::HandleTable ScreenLockManagerStub::handleTable_ =
+    ScreenLockManagerStub::BuildHandleTable();
+
 int32_t ScreenLockManagerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
     MessageOption &option) __attribute__((no_sanitize("cfi")))
 {
@@ -75,19 +85,42 @@ int32_t ScreenLockManagerStub::OnRemoteRequest(uint32_t code, MessageParcel &dat
         return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
     }
 
-    auto itFunc = handleFuncMap.find(code);
-    if (itFunc != handleFuncMap.end()) {
-        auto requestFunc = itFunc->second;
-        if (requestFunc != nullptr) {
-            (this->*requestFunc)(data, reply);
-            return ERR_NONE;
+    if (code < HANDLE_FUNC_COUNT && handleTable_[code].func != nullptr) {
+        auto begin = std::chrono::steady_clock::now();
+        int32_t ret = (this->*handleTable_[code].func)(data, reply);
+        auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+        IpcCodeStats &stats = ipcStats_[code];
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        stats.totalTimeNs.fetch_add(static_cast<uint64_t>(cost.count()), std::memory_order_relaxed);
+        // Handlers return the result code they replied with, or ERR_INVALID_DATA when the request was unreadable.
+        if (ret != ERR_NONE && ret != E_SCREENLOCK_OK) {
+            stats.errors.fetch_add(1, std::memory_order_relaxed);
         }
+        return ERR_NONE;
     }
 
     SCLOCK_HILOGI("Default value received, check needed.");
     return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
 }
 
+void ScreenLockManagerStub::DumpIpcStats(std::string &output)
+{
+    output.append("\n IPC code\t\t\tCalls\tErrors\tAvg(us)\n");
+    for (size_t code = 0; code < HANDLE_FUNC_COUNT; code++) {
+        const IpcCodeStats &stats = ipcStats_[code];
+        uint64_t calls = stats.calls.load(std::memory_order_relaxed);
+        if (handleTable_[code].func == nullptr || calls == 0) {
+            continue;
+        }
+        constexpr uint64_t nsPerUs = 1000;
+        uint64_t avgUs = stats.totalTimeNs.load(std::memory_order_relaxed) / calls / nsPerUs;
+        output.append(" * ").append(handleTable_[code].name).append("(" + std::to_string(code) + ")")
+            .append("\t" + std::to_string(calls))
+            .append("\t" + std::to_string(stats.errors.load(std::memory_order_relaxed)))
+            .append("\t" + std::to_string(avgUs) + "\n");
+    }
+}
+
 int32_t ScreenLockManagerStub::OnIsLocked(MessageParcel &data, MessageParcel &reply)
 {
     bool isLocked = false;
@@ -96,7 +129,7 @@ int32_t ScreenLockManagerStub::OnIsLocked(MessageParcel &data, MessageParcel &re
     if (ret == E_SCREENLOCK_OK) {
         reply.WriteBool(isLocked);
     }
-    return ERR_NONE;
+    return ret;
 }
 
 int32_t ScreenLockManagerStub::OnIsScreenLocked(MessageParcel &data, MessageParcel &reply)
@@ -128,7 +161,7 @@ int32_t ScreenLockManagerStub::OnUnlock(MessageParcel &data, MessageParcel &repl
     }
     int32_t ret = Unlock(listener);
     reply.WriteInt32(ret);
-    return ERR_NONE;
+    return ret;
 }
 
 int32_t ScreenLockManagerStub::OnUnlockScreen(MessageParcel &data, MessageParcel &reply)
@@ -145,7 +178,7 @@ int32_t ScreenLockManagerStub::OnUnlockScreen(MessageParcel &data, MessageParcel
     }
     int32_t ret = UnlockScreen(listener);
     reply.WriteInt32(ret);
-    return ERR_NONE;
+    return ret;
 }
 
 int32_t ScreenLockManagerStub::OnLock(MessageParcel &data, MessageParcel &reply)
@@ -162,7 +195,7 @@ int32_t ScreenLockManagerStub::OnLock(MessageParcel &data, MessageParcel &reply)
     }
     int32_t status = Lock(listener);
     reply.WriteInt32(status);
-    return ERR_NONE;
+    return status;
 }
 
 int32_t ScreenLockManagerStub::OnScreenLockOn(MessageParcel &data, MessageParcel &reply)
@@ -179,7 +212,7 @@ int32_t ScreenLockManagerStub::OnScreenLockOn(MessageParcel &data, MessageParcel
     }
     int32_t ret = OnSystemEvent(listener);
     reply.WriteInt32(ret);
-    return ERR_NONE;
+    return ret;
 }
 
 int32_t ScreenLockManagerStub::OnSendScreenLockEvent(MessageParcel &data, MessageParcel &reply)
@@ -189,7 +222,7 @@ int32_t ScreenLockManagerStub::OnSendScreenLockEvent(MessageParcel &data, Messag
     SCLOCK_HILOGD("event=%{public}s, param=%{public}d", event.c_str(), param);
     int32_t retCode = SendScreenLockEvent(event, param);
     reply.WriteInt32(retCode);
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnIsScreenLockDisabled(MessageParcel &data, MessageParcel &reply)
@@ -202,7 +235,7 @@ int32_t ScreenLockManagerStub::OnIsScreenLockDisabled(MessageParcel &data, Messa
     if (retCode == E_SCREENLOCK_OK) {
         reply.WriteBool(isDisabled);
     }
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnSetScreenLockDisabled(MessageParcel &data, MessageParcel &reply)
@@ -212,7 +245,7 @@ int32_t ScreenLockManagerStub::OnSetScreenLockDisabled(MessageParcel &data, Mess
     SCLOCK_HILOGD("disable=%{public}d, userId=%{public}d", disable, userId);
     int32_t retCode = SetScreenLockDisabled(disable, userId);
     reply.WriteInt32(retCode);
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnSetScreenLockAuthState(MessageParcel &data, MessageParcel &reply)
@@ -222,7 +255,7 @@ int32_t ScreenLockManagerStub::OnSetScreenLockAuthState(MessageParcel &data, Mes
     std::string authToken = data.ReadString();
     int32_t retCode = SetScreenLockAuthState(authState, userId, authToken);
     reply.WriteInt32(retCode);
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnGetScreenLockAuthState(MessageParcel &data, MessageParcel &reply)
@@ -235,7 +268,7 @@ int32_t ScreenLockManagerStub::OnGetScreenLockAuthState(MessageParcel &data, Mes
     if (retCode == E_SCREENLOCK_OK) {
         reply.WriteInt32(authState);
     }
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnRequestStrongAuth(MessageParcel &data, MessageParcel &reply)
@@ -245,7 +278,7 @@ int32_t ScreenLockManagerStub::OnRequestStrongAuth(MessageParcel &data, MessageP
     SCLOCK_HILOGD("OnRequestStrongAuth. reasonFlag=%{public}d", reasonFlag);
     int32_t retCode = RequestStrongAuth(reasonFlag, userId);
     reply.WriteInt32(retCode);
-    return ERR_NONE;
+    return retCode;
 }
 
 int32_t ScreenLockManagerStub::OnGetStrongAuth(MessageParcel &data, MessageParcel &reply)
@@ -258,6 +291,112 @@ int32_t ScreenLockManagerStub::OnGetStrongAuth(MessageParcel &data, MessageParce
     if (retCode == E_SCREENLOCK_OK) {
         reply.WriteInt32(reasonFlag);
     }
+    return retCode;
+}
+
+int32_t ScreenLockManagerStub::OnGetSharedState(MessageParcel &data, MessageParcel &reply)
+{
+    sptr<Ashmem> ashmem = nullptr;
+    bool isLockQueryAllowed = false;
+    int32_t retCode = GetSharedState(ashmem, isLockQueryAllowed);
+    reply.WriteInt32(retCode);
+    if (retCode == E_SCREENLOCK_OK) {
+        reply.WriteBool(isLockQueryAllowed);
+        if (!reply.WriteAshmem(ashmem)) {
+            SCLOCK_HILOGE("write ashmem failed");
+            return ERR_INVALID_DATA;
+        }
+    }
+    return retCode;
+}
+
+int32_t ScreenLockManagerStub::OnGetStateSnapshot(MessageParcel &data, MessageParcel &reply)
+{
+    ScreenLockStateSnapshot snapshot;
+    int32_t userId = data.ReadInt32();
+    int32_t retCode = GetStateSnapshot(userId, snapshot);
+    reply.WriteInt32(retCode);
+    if (retCode == E_SCREENLOCK_OK) {
+        reply.WriteInt32(snapshot.version);
+        reply.WriteBool(snapshot.isLocked);
+        reply.WriteBool(snapshot.isSecure);
+        reply.WriteBool(snapshot.isDisabled);
+        reply.WriteInt32(snapshot.authState);
+        reply.WriteInt32(snapshot.strongAuthReason);
+    }
+    return retCode;
+}
+
+sptr<ScreenLockSystemAbilityInterface> ScreenLockManagerStub::ReadSystemEventListener(MessageParcel &data)
+{
+    sptr<IRemoteObject> remote = data.ReadRemoteObject();
+    if (remote == nullptr) {
+        SCLOCK_HILOGE("ScreenLockManagerStub remote is nullptr");
+        return nullptr;
+    }
+    return iface_cast<ScreenLockSystemAbilityInterface>(remote);
+}
+
+int32_t ScreenLockManagerStub::OnSubscribeSystemEvent(MessageParcel &data, MessageParcel &reply)
+{
+    sptr<ScreenLockSystemAbilityInterface> listener = ReadSystemEventListener(data);
+    if (listener == nullptr) {
+        return ERR_INVALID_DATA;
+    }
+    std::vector<std::string> eventTypes;
+    if (!data.ReadStringVector(&eventTypes)) {
+        SCLOCK_HILOGE("read event types failed");
+        return ERR_INVALID_DATA;
+    }
+    int32_t retCode = SubscribeSystemEvent(listener, eventTypes);
+    reply.WriteInt32(retCode);
+    return retCode;
+}
+
+int32_t ScreenLockManagerStub::OnUnsubscribeSystemEvent(MessageParcel &data, MessageParcel &reply)
+{
+    sptr<ScreenLockSystemAbilityInterface> listener = ReadSystemEventListener(data);
+    if (listener == nullptr) {
+        return ERR_INVALID_DATA;
+    }
+    int32_t retCode = UnsubscribeSystemEvent(listener);
+    reply.WriteInt32(retCode);
+    return retCode;
+}
+
+int32_t ScreenLockManagerStub::OnGetMissedEvents(MessageParcel &data, MessageParcel &reply)
+{
+    uint64_t epoch = data.ReadUint64();
+    uint64_t lastSeq = data.ReadUint64();
+    ScreenLockEventResync resync;
+    std::vector<SystemEvent> events;
+    int32_t retCode = GetMissedEvents(epoch, lastSeq, resync, events);
+    reply.WriteInt32(retCode);
+    if (retCode != E_SCREENLOCK_OK) {
+        return retCode;
+    }
+    reply.WriteUint64(resync.epoch);
+    reply.WriteUint64(resync.latestSeq);
+    reply.WriteBool(resync.isFullSync);
+    if (resync.isFullSync) {
+        reply.WriteInt32(resync.currentUser);
+        reply.WriteInt32(resync.screenState);
+        reply.WriteInt32(resync.interactiveState);
+        reply.WriteInt32(resync.snapshot.version);
+        reply.WriteBool(resync.snapshot.isLocked);
+        reply.WriteBool(resync.snapshot.isSecure);
+        reply.WriteBool(resync.snapshot.isDisabled);
+        reply.WriteInt32(resync.snapshot.authState);
+        reply.WriteInt32(resync.snapshot.strongAuthReason);
+        return ERR_NONE;
+    }
+    reply.WriteUint32(static_cast<uint32_t>(events.size()));
+    for (const auto &event : events) {
+        reply.WriteInt32(static_cast<int32_t>(event.eventId_));
+        reply.WriteString(event.params_);
+        reply.WriteInt32(event.userId_);
+        reply.WriteUint64(event.seq_);
+    }
     return ERR_NONE;
 }
 
@@ -266,7 +405,7 @@ int32_t ScreenLockManagerStub::OnLockScreen(MessageParcel &data, MessageParcel &
     int32_t useId = data.ReadInt32();
     int32_t retCode = Lock(useId);
     reply.WriteInt32(retCode);
-    return ERR_NONE;
+    return retCode;
 }
 } // namespace ScreenLock
 } // namespace OHOS
\ No newline at end of file
@@ -14,7 +14,9 @@
  */
 #include "screenlock_system_ability.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cinttypes>
 #include <ctime>
 #include <fcntl.h>
 #include <functional>
@@ -37,6 +39,7 @@
 #include "iservice_registry.h"
 #include "os_account_manager.h"
 #include "parameter.h"
+#include "permission_cache.h"
 #include "sclock_log.h"
 #include "screenlock_common.h"
 #include "screenlock_get_info_callback.h"
@@ -51,6 +54,7 @@
 #include "user_auth_client_callback.h"
 #include "user_auth_client_impl.h"
 #include "strongauthmanager.h"
+#include "string_ex.h"
 
 using namespace OHOS;
 using namespace OHOS::ScreenLock;
@@ -70,9 +74,37 @@ const std::int64_t DELAY_TIME = 1000000L;
 std::mutex ScreenLockSystemAbility::instanceLock_;
 sptr<ScreenLockSystemAbility> ScreenLockSystemAbility::instance_;
 constexpr int32_t MAX_RETRY_TIMES = 20;
+constexpr const char *PENDING_LISTENER_CAPACITY_PARAM = "const.screenlock.pending_listener_capacity";
+constexpr int32_t DEFAULT_PENDING_LISTENER_CAPACITY = 32;
+constexpr uint32_t PARAM_VALUE_LEN = 16;
+// An unlock request that got no result within this time is treated as lost, the next request prompts again.
+constexpr std::chrono::milliseconds UNLOCK_REQUEST_STALE_TIME(10000);
+constexpr const char *USER_STORE_PATH = "/data/service/el1/public/screenlock/screenlock_user_state.bin";
+// Set in screenlock_state.xml once its flags are copied, a store reset later must not bring them back.
+constexpr const char *USER_STORE_MIGRATED_KEY = "userStoreMigrated";
 std::shared_ptr<ffrt::queue> ScreenLockSystemAbility::queue_;
+
+static size_t GetPendingListenerCapacity()
+{
+    char value[PARAM_VALUE_LEN] = { 0 };
+    int32_t capacity = 0;
+    if (GetParameter(PENDING_LISTENER_CAPACITY_PARAM, "", value, PARAM_VALUE_LEN) > 0 && StrToInt(value, capacity) &&
+        capacity > 0) {
+        return static_cast<size_t>(capacity);
+    }
+    return DEFAULT_PENDING_LISTENER_CAPACITY;
+}
+
+static int64_t GetWallTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 ScreenLockSystemAbility::ScreenLockSystemAbility(int32_t systemAbilityId, bool runOnCreate)
-    : SystemAbility(systemAbilityId, runOnCreate), state_(ServiceRunningState::STATE_NOT_START)
+    : SystemAbility(systemAbilityId, runOnCreate), state_(ServiceRunningState::STATE_NOT_START),
+      unlockListeners_("unlock", GetPendingListenerCapacity()),
+      lockListeners_("lock", GetPendingListenerCapacity())
 {}
 
 ScreenLockSystemAbility::~ScreenLockSystemAbility() {}
@@ -111,17 +143,18 @@ void ScreenLockSystemAbility::AccountSubscriber::OnAccountsChanged(const int &id
     SCLOCK_HILOGI("OnAccountsChanged.[osAccountId]:%{public}d, [lastId]:%{public}d", id, userId_);
     StrongAuthManger::GetInstance()->StartStrongAuthTimer(id);
     userId_ = id;
-    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
-    if (preferencesUtil == nullptr) {
-        SCLOCK_HILOGE("preferencesUtil is nullptr!");
-        return;
-    }
-    if (preferencesUtil->ObtainBool(std::to_string(id), false)) {
-        return;
-    }
-    preferencesUtil->SaveBool(std::to_string(id), false);
-    preferencesUtil->Refresh();
-    return;
+    ScreenLockSystemAbility::GetInstance()->stateValue_.SetCurrentUser(id);
+    ScreenLockSystemAbility::GetInstance()->InitUserState(id);
+}
+
+ScreenLockSystemAbility::AccountRemovedSubscriber::AccountRemovedSubscriber(
+    const OsAccountSubscribeInfo &subscribeInfo) : OsAccountSubscriber(subscribeInfo)
+{}
+
+void ScreenLockSystemAbility::AccountRemovedSubscriber::OnAccountsChanged(const int &id)
+{
+    SCLOCK_HILOGI("OnAccountRemoved.[osAccountId]:%{public}d", id);
+    ScreenLockSystemAbility::GetInstance()->RemoveUserState(id);
 }
 
 int32_t ScreenLockSystemAbility::Init()
@@ -147,6 +180,11 @@ void ScreenLockSystemAbility::OnStart()
         return;
     }
     InitServiceHandler();
+    InitUserStore();
+    PreloadUserDisabled();
+    if (!stateValue_.InitSharedState()) {
+        SCLOCK_HILOGW("InitSharedState failed, clients fall back to IPC.");
+    }
     if (Init() != ERR_OK) {
         auto callback = [=]() { Init(); };
         queue_->submit(callback, ffrt::task_attr().delay(INIT_INTERVAL));
@@ -155,6 +193,8 @@ void ScreenLockSystemAbility::OnStart()
     AddSystemAbilityListener(DISPLAY_MANAGER_SERVICE_SA_ID);
     AddSystemAbilityListener(SUBSYS_ACCOUNT_SYS_ABILITY_ID_BEGIN);
     AddSystemAbilityListener(SUBSYS_USERIAM_SYS_ABILITY_USERIDM);
+    AddSystemAbilityListener(ACCESS_TOKEN_MANAGER_SERVICE_ID);
+    AddSystemAbilityListener(WINDOW_MANAGER_SERVICE_ID);
     RegisterDumpCommand();
     return;
 }
@@ -171,10 +211,81 @@ void ScreenLockSystemAbility::OnAddSystemAbility(int32_t systemAbilityId, const
     }
     if (systemAbilityId == SUBSYS_ACCOUNT_SYS_ABILITY_ID_BEGIN) {
         InitUserId();
+        PreloadUserDisabled();
     }
     if (systemAbilityId == SUBSYS_USERIAM_SYS_ABILITY_USERIDM) {
         StrongAuthManger::GetInstance()->RegistUserAuthSuccessEventListener();
     }
+    if (systemAbilityId == ACCESS_TOKEN_MANAGER_SERVICE_ID) {
+        PermissionCache::GetInstance()->RegisterPermStateChangeCallback();
+    }
+    if (systemAbilityId == WINDOW_MANAGER_SERVICE_ID) {
+        RegisterFocusChangedListener();
+    }
+}
+
+void ScreenLockSystemAbility::OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
+{
+    SCLOCK_HILOGI("OnRemoveSystemAbility systemAbilityId:%{public}d removed!", systemAbilityId);
+    if (systemAbilityId == ACCESS_TOKEN_MANAGER_SERVICE_ID) {
+        // The state change callback died with the service, cached verdicts can no longer be trusted.
+        PermissionCache::GetInstance()->UnRegisterPermStateChangeCallback();
+    }
+    if (systemAbilityId == WINDOW_MANAGER_SERVICE_ID) {
+        // Focus events are lost until the window manager is back, fall back to querying it.
+        focusCacheValid_ = false;
+    }
+}
+
+void ScreenLockSystemAbility::RegisterFocusChangedListener()
+{
+    if (focusChangedListener_ == nullptr) {
+        focusChangedListener_ = new ScreenLockSystemAbility::ScreenLockFocusChangedListener();
+    }
+    WMError ret = WindowManager::GetInstance().RegisterFocusChangedListener(focusChangedListener_);
+    if (ret != WMError::WM_OK) {
+        SCLOCK_HILOGE("RegisterFocusChangedListener failed, ret = %{public}d", static_cast<int32_t>(ret));
+        focusCacheValid_ = false;
+        return;
+    }
+    uint64_t eventCount = focusEventCount_;
+    FocusChangeInfo focusInfo;
+    WindowManager::GetInstance().GetFocusWindowInfo(focusInfo);
+    // A focus event delivered meanwhile is newer than the queried value.
+    if (focusEventCount_ == eventCount) {
+        focusedPid_ = focusInfo.pid_;
+    }
+    focusCacheValid_ = true;
+    SCLOCK_HILOGI("RegisterFocusChangedListener success, focused pid = %{public}d", focusedPid_.load());
+}
+
+void ScreenLockSystemAbility::OnFocusChanged(int32_t pid, bool focused)
+{
+    focusEventCount_++;
+    if (focused) {
+        focusedPid_ = pid;
+        return;
+    }
+    int32_t expected = pid;
+    focusedPid_.compare_exchange_strong(expected, -1);
+}
+
+void ScreenLockSystemAbility::ScreenLockFocusChangedListener::OnFocused(
+    const sptr<FocusChangeInfo> &focusChangeInfo)
+{
+    if (focusChangeInfo == nullptr) {
+        return;
+    }
+    ScreenLockSystemAbility::GetInstance()->OnFocusChanged(focusChangeInfo->pid_, true);
+}
+
+void ScreenLockSystemAbility::ScreenLockFocusChangedListener::OnUnfocused(
+    const sptr<FocusChangeInfo> &focusChangeInfo)
+{
+    if (focusChangeInfo == nullptr) {
+        return;
+    }
+    ScreenLockSystemAbility::GetInstance()->OnFocusChanged(focusChangeInfo->pid_, false);
 }
 
 void ScreenLockSystemAbility::RegisterDisplayPowerEventListener(int32_t times)
@@ -189,6 +300,7 @@ void ScreenLockSystemAbility::RegisterDisplayPowerEventListener(int32_t times)
     } else if (systemReady_) {
         state_ = ServiceRunningState::STATE_RUNNING;
         SCLOCK_HILOGI("systemReady_ is true");
+        TryNotifySystemReady();
     }
     SCLOCK_HILOGI("RegisterDisplayPowerEventListener, times:%{public}d", times);
 }
@@ -199,7 +311,7 @@ void ScreenLockSystemAbility::InitServiceHandler()
         SCLOCK_HILOGI("InitServiceHandler already init.");
         return;
     }
-    queue_ = std::make_shared<ffrt::queue>("ScreenLockSystemAbility");
+    queue_ = std::make_shared<ffrt::queue>("ScreenLockSystemAbility", ffrt::queue_attr().qos(ffrt::qos_default));
     SCLOCK_HILOGI("InitServiceHandler succeeded.");
 }
 
@@ -214,20 +326,199 @@ void ScreenLockSystemAbility::InitUserId()
     if (ret != ERR_OK) {
         SCLOCK_HILOGE("SubscribeOsAccount failed.[ret]:%{public}d", ret);
     }
+    // Account ids are not reused, the state of a removed account would otherwise hold its slot for good.
+    OsAccountSubscribeInfo removedSubscribeInfo;
+    removedSubscribeInfo.SetOsAccountSubscribeType(OS_ACCOUNT_SUBSCRIBE_TYPE::REMOVED);
+    accountRemovedSubscriber_ = std::make_shared<AccountRemovedSubscriber>(removedSubscribeInfo);
+    ret = OsAccountManager::SubscribeOsAccount(accountRemovedSubscriber_);
+    if (ret != ERR_OK) {
+        SCLOCK_HILOGE("SubscribeOsAccount removed failed.[ret]:%{public}d", ret);
+    }
     Singleton<CommeventMgr>::GetInstance().SubscribeEvent();
+    stateValue_.SetCredentialTracked(Singleton<CommeventMgr>::GetInstance().IsSubscribed());
 
-    int userId = GetCurrentActiveOsAccountId();
+    int32_t userId = GetCurrentActiveOsAccountId();
+    if (userId != SCREEN_FAIL) {
+        stateValue_.SetCurrentUser(userId);
+    }
+    InitUserState(userId);
+}
+
+void ScreenLockSystemAbility::InitUserStore()
+{
+    if (!userStore_.Open(USER_STORE_PATH)) {
+        SCLOCK_HILOGW("open user store failed, use preferences instead.");
+        return;
+    }
+    if (!userStore_.IsCreated()) {
+        return;
+    }
+    // One-time migration of the disabled flags kept in screenlock_state.xml.
     auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
     if (preferencesUtil == nullptr) {
         SCLOCK_HILOGE("preferencesUtil is nullptr!");
         return;
     }
-    if (preferencesUtil->ObtainBool(std::to_string(userId), false)) {
+    if (preferencesUtil->ObtainBool(USER_STORE_MIGRATED_KEY, false)) {
+        SCLOCK_HILOGW("user store reset after migration, the xml is stale and not imported again.");
         return;
     }
-    preferencesUtil->SaveBool(std::to_string(userId), false);
+    std::lock_guard<std::mutex> lock(userStateMutex_);
+    int64_t now = GetWallTimeMs();
+    for (const auto &[key, isDisabled] : preferencesUtil->ObtainAllBool()) {
+        UserStateRecord record;
+        // Users already recovered from the journal are newer than the xml.
+        if (!StrToInt(key, record.userId) || userStore_.Get(record.userId, record)) {
+            continue;
+        }
+        record.isDisabled = isDisabled;
+        record.disabledUpdateTime = now;
+        userStore_.Put(record);
+    }
+    userStore_.Sync();
+    preferencesUtil->SaveBool(USER_STORE_MIGRATED_KEY, true);
+    preferencesUtil->RefreshSync();
+    SCLOCK_HILOGI("user store migrated, users = %{public}zu", userStore_.GetAll().size());
+}
+
+void ScreenLockSystemAbility::PreloadUserDisabled()
+{
+    // Held across the load so a flag set meanwhile is not overwritten by the older value.
+    std::lock_guard<std::mutex> writeLock(disabledWriteMutex_);
+    std::map<int32_t, bool> disabledUsers;
+    if (userStore_.IsValid()) {
+        for (const auto &record : userStore_.GetAll()) {
+            disabledUsers.emplace(record.userId, record.isDisabled);
+        }
+    } else {
+        auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+        if (preferencesUtil == nullptr) {
+            SCLOCK_HILOGE("preferencesUtil is nullptr!");
+            return;
+        }
+        for (const auto &[key, isDisabled] : preferencesUtil->ObtainAllBool()) {
+            int32_t userId = 0;
+            if (StrToInt(key, userId)) {
+                disabledUsers.emplace(userId, isDisabled);
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(disabledCacheMutex_);
+    disabledCache_.swap(disabledUsers);
+    disabledCacheLoaded_ = true;
+    SCLOCK_HILOGI("preload disabled flags, users = %{public}zu", disabledCache_.size());
+}
+
+bool ScreenLockSystemAbility::GetUserDisabled(int32_t userId, bool &isDisabled)
+{
+    {
+        std::lock_guard<std::mutex> lock(disabledCacheMutex_);
+        if (disabledCacheLoaded_) {
+            auto iter = disabledCache_.find(userId);
+            isDisabled = iter != disabledCache_.end() && iter->second;
+            return true;
+        }
+    }
+    if (userStore_.IsValid()) {
+        UserStateRecord record;
+        isDisabled = userStore_.Get(userId, record) && record.isDisabled;
+        return true;
+    }
+    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+    if (preferencesUtil == nullptr) {
+        SCLOCK_HILOGE("preferencesUtil is nullptr!");
+        return false;
+    }
+    isDisabled = preferencesUtil->ObtainBool(std::to_string(userId), false);
+    return true;
+}
+
+bool ScreenLockSystemAbility::SetUserDisabled(int32_t userId, bool isDisabled)
+{
+    // Readers keep being served from disabledCache_ while the write reaches disk.
+    std::lock_guard<std::mutex> writeLock(disabledWriteMutex_);
+    if (userStore_.IsValid()) {
+        int64_t now = GetWallTimeMs();
+        bool saved = UpdateUserState(userId, [isDisabled, now](UserStateRecord &record) {
+            record.isDisabled = isDisabled;
+            record.disabledUpdateTime = now;
+        });
+        // An acknowledged setting must survive a power cut, so it does not wait for the group commit.
+        if (!saved || !userStore_.Sync()) {
+            return false;
+        }
+    } else {
+        auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+        if (preferencesUtil == nullptr) {
+            SCLOCK_HILOGE("preferencesUtil is nullptr!");
+            return false;
+        }
+        preferencesUtil->SaveBool(std::to_string(userId), isDisabled);
+        preferencesUtil->Refresh();
+    }
+    std::lock_guard<std::mutex> lock(disabledCacheMutex_);
+    if (disabledCacheLoaded_) {
+        disabledCache_[userId] = isDisabled;
+    }
+    return true;
+}
+
+void ScreenLockSystemAbility::InitUserState(int32_t userId)
+{
+    if (userStore_.IsValid()) {
+        UpdateUserState(userId, [](UserStateRecord &) {});
+        return;
+    }
+    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+    if (preferencesUtil == nullptr) {
+        SCLOCK_HILOGE("preferencesUtil is nullptr!");
+        return;
+    }
+    PreferencesUtil::Transaction transaction(*preferencesUtil);
+    if (transaction.ObtainBool(std::to_string(userId), false)) {
+        return;
+    }
+    transaction.SaveBool(std::to_string(userId), false);
+    transaction.Commit();
+}
+
+void ScreenLockSystemAbility::RemoveUserState(int32_t userId)
+{
+    std::lock_guard<std::mutex> writeLock(disabledWriteMutex_);
+    {
+        std::lock_guard<std::mutex> lock(disabledCacheMutex_);
+        disabledCache_.erase(userId);
+    }
+    if (userStore_.IsValid()) {
+        std::lock_guard<std::mutex> stateLock(userStateMutex_);
+        userStore_.Remove(userId);
+        return;
+    }
+    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+    if (preferencesUtil == nullptr) {
+        SCLOCK_HILOGE("preferencesUtil is nullptr!");
+        return;
+    }
+    preferencesUtil->RemoveKey(std::to_string(userId));
     preferencesUtil->Refresh();
-    return;
+}
+
+bool ScreenLockSystemAbility::UpdateUserState(int32_t userId, const std::function<void(UserStateRecord &)> &update)
+{
+    if (!userStore_.IsValid()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(userStateMutex_);
+    UserStateRecord record;
+    if (!userStore_.Get(userId, record)) {
+        record.userId = userId;
+    }
+    update(record);
+    if (!userStore_.Put(record)) {
+        SCLOCK_HILOGE("save user state failed, userId = %{public}d", userId);
+        return false;
+    }
+    return true;
 }
 
 void ScreenLockSystemAbility::OnStop()
@@ -238,14 +529,22 @@ void ScreenLockSystemAbility::OnStop()
     }
     queue_ = nullptr;
     instance_ = nullptr;
+    userStore_.Sync();
     state_ = ServiceRunningState::STATE_NOT_START;
     DisplayManager::GetInstance().UnregisterDisplayPowerEventListener(displayPowerEventListener_);
+    WindowManager::GetInstance().UnregisterFocusChangedListener(focusChangedListener_);
+    focusCacheValid_ = false;
     StrongAuthManger::GetInstance()->UnRegistUserAuthSuccessEventListener();
     StrongAuthManger::GetInstance()->DestroyAllStrongAuthTimer();
+    PermissionCache::GetInstance()->UnRegisterPermStateChangeCallback();
     int ret = OsAccountManager::UnsubscribeOsAccount(accountSubscriber_);
     if (ret != SUCCESS) {
         SCLOCK_HILOGE("unsubscribe os account failed, code=%{public}d", ret);
     }
+    ret = OsAccountManager::UnsubscribeOsAccount(accountRemovedSubscriber_);
+    if (ret != SUCCESS) {
+        SCLOCK_HILOGE("unsubscribe os account removed failed, code=%{public}d", ret);
+    }
     SCLOCK_HILOGI("OnStop end.");
 }
 
@@ -277,85 +576,103 @@ void ScreenLockSystemAbility::ScreenLockDisplayPowerEventListener::OnDisplayPowe
 
 void ScreenLockSystemAbility::OnScreenOff(EventStatus status)
 {
-    SystemEvent systemEvent(BEGIN_SCREEN_OFF);
+    SystemEvent systemEvent(SystemEventId::BEGIN_SCREEN_OFF);
     if (status == EventStatus::BEGIN) {
         stateValue_.SetScreenState(static_cast<int32_t>(ScreenState::SCREEN_STATE_BEGIN_OFF));
     } else if (status == EventStatus::END) {
         stateValue_.SetScreenState(static_cast<int32_t>(ScreenState::SCREEN_STATE_END_OFF));
-        systemEvent.eventType_ = END_SCREEN_OFF;
+        systemEvent.eventId_ = SystemEventId::END_SCREEN_OFF;
     }
     SystemEventCallBack(systemEvent);
 }
 
 void ScreenLockSystemAbility::OnScreenOn(EventStatus status)
 {
-    SystemEvent systemEvent(BEGIN_SCREEN_ON);
+    SystemEvent systemEvent(SystemEventId::BEGIN_SCREEN_ON);
     if (status == EventStatus::BEGIN) {
         stateValue_.SetScreenState(static_cast<int32_t>(ScreenState::SCREEN_STATE_BEGIN_ON));
     } else if (status == EventStatus::END) {
         stateValue_.SetScreenState(static_cast<int32_t>(ScreenState::SCREEN_STATE_END_ON));
-        systemEvent.eventType_ = END_SCREEN_ON;
+        systemEvent.eventId_ = SystemEventId::END_SCREEN_ON;
     }
     SystemEventCallBack(systemEvent);
 }
 
+void ScreenLockSystemAbility::TryNotifySystemReady()
+{
+    // Called by both halves of the readiness pair; whichever completes it emits SYSTEM_READY, exactly once
+    // per registered listener.
+    {
+        std::lock_guard<std::mutex> lock(readinessMutex_);
+        if (!systemReady_ || !systemReadyPending_) {
+            SCLOCK_HILOGI("system ready deferred, systemReady_ = %{public}d, pending = %{public}d",
+                systemReady_.load(), systemReadyPending_);
+            return;
+        }
+        systemReadyPending_ = false;
+    }
+    if (queue_ == nullptr) {
+        return;
+    }
+    queue_->submit([this]() { OnSystemReady(); });
+}
+
 void ScreenLockSystemAbility::OnSystemReady()
 {
     SCLOCK_HILOGI("ScreenLockSystemAbility OnSystemReady started.");
-    bool isExitFlag = false;
-    int tryTime = 50;
-    int minTryTime = 0;
-    while (!isExitFlag && (tryTime > minTryTime)) {
-        if (systemEventListener_ != nullptr && systemReady_) {
-            SCLOCK_HILOGI("ScreenLockSystemAbility OnSystemReady started1.");
-            std::lock_guard<std::mutex> lck(listenerMutex_);
-            SystemEvent systemEvent(SYSTEM_READY);
-            systemEventListener_->OnCallBack(systemEvent);
-            isExitFlag = true;
-        } else {
-            SCLOCK_HILOGE("ScreenLockSystemAbility OnSystemReady type not found., tryTime = %{public}d", tryTime);
-            sleep(1);
-        }
-        --tryTime;
+    std::lock_guard<std::mutex> lck(listenerMutex_);
+    if (systemEventListener_ == nullptr) {
+        SCLOCK_HILOGE("systemEventListener_ is nullptr.");
+        return;
     }
+    SystemEvent systemEvent(SystemEventId::SYSTEM_READY);
+    // Not kept in the history, so it carries the seq of the last event before it instead of a new one.
+    systemEvent.seq_ = eventBus_.GetLatestSeq();
+    systemEventListener_->OnCallBack(systemEvent);
 }
 
 void ScreenLockSystemAbility::OnWakeUp(EventStatus status)
 {
-    SystemEvent systemEvent(BEGIN_WAKEUP);
+    SystemEvent systemEvent(SystemEventId::BEGIN_WAKEUP);
     if (status == EventStatus::BEGIN) {
+        wakeUpTimeNs_ = std::chrono::steady_clock::now().time_since_epoch().count();
         stateValue_.SetInteractiveState(static_cast<int32_t>(InteractiveState::INTERACTIVE_STATE_BEGIN_WAKEUP));
     } else if (status == EventStatus::END) {
         stateValue_.SetInteractiveState(static_cast<int32_t>(InteractiveState::INTERACTIVE_STATE_END_WAKEUP));
-        systemEvent.eventType_ = END_WAKEUP;
+        systemEvent.eventId_ = SystemEventId::END_WAKEUP;
     }
     SystemEventCallBack(systemEvent);
 }
 
 void ScreenLockSystemAbility::OnSleep(EventStatus status)
 {
-    SystemEvent systemEvent(BEGIN_SLEEP);
+    SystemEvent systemEvent(SystemEventId::BEGIN_SLEEP);
     if (status == EventStatus::BEGIN) {
         stateValue_.SetInteractiveState(static_cast<int32_t>(InteractiveState::INTERACTIVE_STATE_BEGIN_SLEEP));
     } else if (status == EventStatus::END) {
         stateValue_.SetInteractiveState(static_cast<int32_t>(InteractiveState::INTERACTIVE_STATE_END_SLEEP));
-        systemEvent.eventType_ = END_SLEEP;
+        systemEvent.eventId_ = SystemEventId::END_SLEEP;
     }
     SystemEventCallBack(systemEvent);
 }
 
 void ScreenLockSystemAbility::OnExitAnimation()
 {
-    SystemEvent systemEvent(EXIT_ANIMATION);
+    SystemEvent systemEvent(SystemEventId::EXIT_ANIMATION);
     SystemEventCallBack(systemEvent);
 }
 
 void ScreenLockSystemAbility::StrongAuthChanged(int32_t userId, int32_t reasonFlag)
 {
-    SystemEvent systemEvent(STRONG_AUTH_CHANGED);
+    SystemEvent systemEvent(SystemEventId::STRONG_AUTH_CHANGED);
     systemEvent.userId_ = userId;
     systemEvent.params_ = std::to_string(reasonFlag);
     SystemEventCallBack(systemEvent);
+    int64_t now = GetWallTimeMs();
+    UpdateUserState(userId, [reasonFlag, now](UserStateRecord &record) {
+        record.strongAuthReason = reasonFlag;
+        record.authUpdateTime = now;
+    });
     SCLOCK_HILOGI("StrongAuthChanged: userId: %{public}d, reasonFlag:%{public}d", userId, reasonFlag);
 }
 
@@ -385,16 +702,25 @@ int32_t ScreenLockSystemAbility::UnlockInner(const sptr<ScreenLockCallbackInterf
     // check whether the page of app request unlock is the focus page
     bool hasPermission = CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK");
     SCLOCK_HILOGE("hasPermission: {public}%d.", hasPermission);
-    if (AccessTokenKit::GetTokenTypeFlag(callerTokenId) != TOKEN_NATIVE &&
-        !IsAppInForeground(IPCSkeleton::GetCallingPid(), callerTokenId) && !hasPermission) {
+    if (AccessTokenKit::GetTokenTypeFlag(callerTokenId) != TOKEN_NATIVE && !hasPermission &&
+        !IsAppInForeground(IPCSkeleton::GetCallingPid(), callerTokenId)) {
         FinishAsyncTrace(HITRACE_TAG_MISC, "UnlockScreen end, Unfocused", HITRACE_UNLOCKSCREEN);
         SCLOCK_HILOGE("UnlockScreen  Unfocused.");
         return E_SCREENLOCK_NOT_FOCUS_APP;
     }
-    unlockListenerMutex_.lock();
-    unlockVecListeners_.push_back(listener);
-    unlockListenerMutex_.unlock();
-    SystemEvent systemEvent(UNLOCKSCREEN);
+    bool joined = false;
+    int32_t ret = unlockListeners_.Add(listener, callerTokenId, UNLOCK_REQUEST_STALE_TIME, joined);
+    if (ret != E_SCREENLOCK_OK) {
+        FinishAsyncTrace(HITRACE_TAG_MISC, "UnlockScreen end, rejected", HITRACE_UNLOCKSCREEN);
+        return ret;
+    }
+    if (joined) {
+        // The keyguard is already prompting for this caller's outstanding request, do not prompt again.
+        SCLOCK_HILOGI("UnlockScreen joined the pending request.");
+        FinishAsyncTrace(HITRACE_TAG_MISC, "UnlockScreen end, joined", HITRACE_UNLOCKSCREEN);
+        return E_SCREENLOCK_OK;
+    }
+    SystemEvent systemEvent(SystemEventId::UNLOCKSCREEN);
     SystemEventCallBack(systemEvent, HITRACE_UNLOCKSCREEN);
     FinishAsyncTrace(HITRACE_TAG_MISC, "UnlockScreen end", HITRACE_UNLOCKSCREEN);
     return E_SCREENLOCK_OK;
@@ -412,11 +738,12 @@ int32_t ScreenLockSystemAbility::Lock(const sptr<ScreenLockCallbackInterface> &l
     if (stateValue_.GetScreenlockedState()) {
         SCLOCK_HILOGI("Currently in a locked screen state");
     }
-    lockListenerMutex_.lock();
-    lockVecListeners_.push_back(listener);
-    lockListenerMutex_.unlock();
+    int32_t ret = lockListeners_.Add(listener);
+    if (ret != E_SCREENLOCK_OK) {
+        return ret;
+    }
 
-    SystemEvent systemEvent(LOCKSCREEN);
+    SystemEvent systemEvent(SystemEventId::LOCKSCREEN);
     SystemEventCallBack(systemEvent, HITRACE_LOCKSCREEN);
     return E_SCREENLOCK_OK;
 }
@@ -429,7 +756,7 @@ int32_t ScreenLockSystemAbility::Lock(int32_t userId)
     if (stateValue_.GetScreenlockedState()) {
         SCLOCK_HILOGI("Currently in a locked screen state");
     }
-    SystemEvent systemEvent(LOCKSCREEN);
+    SystemEvent systemEvent(SystemEventId::LOCKSCREEN);
     SystemEventCallBack(systemEvent, HITRACE_LOCKSCREEN);
     return E_SCREENLOCK_OK;
 }
@@ -468,13 +795,52 @@ bool ScreenLockSystemAbility::GetSecure()
         AccountSA::OsAccountManager::GetForegroundOsAccountLocalId(userId);
     }
     SCLOCK_HILOGD("userId=%{public}d", userId);
+    return IsUserSecure(userId);
+}
+
+bool ScreenLockSystemAbility::IsUserSecure(int32_t userId)
+{
+    // Without the credential update subscription nothing would ever invalidate a cached answer.
+    bool cacheable = stateValue_.GetCredentialTracked();
+    uint64_t generation = 0;
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock(secureCacheMutex_);
+        auto iter = secureCache_.find(userId);
+        if (iter != secureCache_.end()) {
+            return iter->second;
+        }
+        generation = secureCacheGeneration_;
+    }
     auto getInfoCallback = std::make_shared<ScreenLockGetInfoCallback>();
     int32_t result = UserIdmClient::GetInstance().GetCredentialInfo(userId, AuthType::PIN, getInfoCallback);
     SCLOCK_HILOGI("GetCredentialInfo AuthType::PIN result = %{public}d", result);
-    if (result == static_cast<int32_t>(ResultCode::SUCCESS)) {
-        return true;
+    bool isSecure = (result == static_cast<int32_t>(ResultCode::SUCCESS));
+    // Only a definitive answer is kept, a transient failure of UserIAM is asked again next time.
+    if (!cacheable || (!isSecure && result != static_cast<int32_t>(ResultCode::NOT_ENROLLED))) {
+        return isSecure;
+    }
+    std::lock_guard<std::mutex> lock(secureCacheMutex_);
+    // A credential update during the query makes this answer stale, so leave the slot empty.
+    if (generation == secureCacheGeneration_) {
+        secureCache_[userId] = isSecure;
+    }
+    return isSecure;
+}
+
+void ScreenLockSystemAbility::OnCredentialUpdated(const std::string &userId)
+{
+    int32_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(secureCacheMutex_);
+        secureCacheGeneration_++;
+        if (StrToInt(userId, id)) {
+            secureCache_.erase(id);
+        } else {
+            SCLOCK_HILOGW("invalid credential update userId, clear all");
+            secureCache_.clear();
+        }
     }
-    return false;
+    stateValue_.BumpCredentialEpoch();
 }
 
 int32_t ScreenLockSystemAbility::OnSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener)
@@ -490,12 +856,42 @@ int32_t ScreenLockSystemAbility::OnSystemEvent(const sptr<ScreenLockSystemAbilit
     systemEventListener_ = listener;
     listenerMutex_.unlock();
     stateValue_.Reset();
-    auto callback = [this]() { OnSystemReady(); };
-    queue_->submit(callback);
+    {
+        std::lock_guard<std::mutex> lock(readinessMutex_);
+        systemReadyPending_ = true;
+    }
+    TryNotifySystemReady();
     SCLOCK_HILOGI("ScreenLockSystemAbility::OnSystemEvent end.");
     return E_SCREENLOCK_OK;
 }
 
+int32_t ScreenLockSystemAbility::SubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener,
+    const std::vector<std::string> &eventTypes)
+{
+    AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    if (AccessTokenKit::GetTokenTypeFlag(callerToken) == TOKEN_HAP && !IsSystemApp()) {
+        SCLOCK_HILOGE("Calling app is not system app");
+        return E_SCREENLOCK_NOT_SYSTEM_APP;
+    }
+    if (!CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK_INNER")) {
+        return E_SCREENLOCK_NO_PERMISSION;
+    }
+    return eventBus_.Subscribe(listener, eventTypes);
+}
+
+int32_t ScreenLockSystemAbility::UnsubscribeSystemEvent(const sptr<ScreenLockSystemAbilityInterface> &listener)
+{
+    AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    if (AccessTokenKit::GetTokenTypeFlag(callerToken) == TOKEN_HAP && !IsSystemApp()) {
+        SCLOCK_HILOGE("Calling app is not system app");
+        return E_SCREENLOCK_NOT_SYSTEM_APP;
+    }
+    if (!CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK_INNER")) {
+        return E_SCREENLOCK_NO_PERMISSION;
+    }
+    return eventBus_.Unsubscribe(listener);
+}
+
 int32_t ScreenLockSystemAbility::SendScreenLockEvent(const std::string &event, int param)
 {
     SCLOCK_HILOGI("SendScreenLockEvent event=%{public}s ,param=%{public}d", event.c_str(), param);
@@ -507,12 +903,18 @@ int32_t ScreenLockSystemAbility::SendScreenLockEvent(const std::string &event, i
         return E_SCREENLOCK_NO_PERMISSION;
     }
     int stateResult = param;
-    if (event == UNLOCK_SCREEN_RESULT) {
-        UnlockScreenEvent(stateResult);
-    } else if (event == SCREEN_DRAWDONE) {
-        NotifyDisplayEvent(DisplayEvent::KEYGUARD_DRAWN);
-    } else if (event == LOCK_SCREEN_RESULT) {
-        LockScreenEvent(stateResult);
+    switch (GetSystemEventId(event)) {
+        case SystemEventId::UNLOCK_SCREEN_RESULT:
+            UnlockScreenEvent(stateResult);
+            break;
+        case SystemEventId::SCREEN_DRAWDONE:
+            NotifyKeyguardDrawn();
+            break;
+        case SystemEventId::LOCK_SCREEN_RESULT:
+            LockScreenEvent(stateResult);
+            break;
+        default:
+            break;
     }
     return E_SCREENLOCK_OK;
 }
@@ -520,16 +922,13 @@ int32_t ScreenLockSystemAbility::SendScreenLockEvent(const std::string &event, i
 int32_t ScreenLockSystemAbility::IsScreenLockDisabled(int userId, bool &isDisabled)
 {
     SCLOCK_HILOGI("IsScreenLockDisabled userId=%{public}d", userId);
-    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
-    if (preferencesUtil == nullptr) {
-        SCLOCK_HILOGE("preferencesUtil is nullptr!");
-        return E_SCREENLOCK_NULLPTR;
-    }
     if (!CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK")) {
         SCLOCK_HILOGE("no permission: userId=%{public}d", userId);
         return E_SCREENLOCK_NO_PERMISSION;
     }
-    isDisabled = preferencesUtil->ObtainBool(std::to_string(userId), false);
+    if (!GetUserDisabled(userId, isDisabled)) {
+        return E_SCREENLOCK_NULLPTR;
+    }
     SCLOCK_HILOGI("IsScreenLockDisabled isDisabled=%{public}d", isDisabled);
     return E_SCREENLOCK_OK;
 }
@@ -549,14 +948,7 @@ int32_t ScreenLockSystemAbility::SetScreenLockDisabled(bool disable, int userId)
         SCLOCK_HILOGE("no permission: userId=%{public}d", userId);
         return E_SCREENLOCK_NO_PERMISSION;
     }
-    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
-    if (preferencesUtil == nullptr) {
-        SCLOCK_HILOGE("preferencesUtil is nullptr!");
-        return E_SCREENLOCK_NULLPTR;
-    }
-    preferencesUtil->SaveBool(std::to_string(userId), disable);
-    preferencesUtil->Refresh();
-    return E_SCREENLOCK_OK;
+    return SetUserDisabled(userId, disable) ? E_SCREENLOCK_OK : SCREEN_FAIL;
 }
 
 int32_t ScreenLockSystemAbility::SetScreenLockAuthState(int authState, int32_t userId, std::string &authToken)
@@ -566,13 +958,16 @@ int32_t ScreenLockSystemAbility::SetScreenLockAuthState(int authState, int32_t u
         SCLOCK_HILOGE("no permission: userId=%{public}d", userId);
         return E_SCREENLOCK_NO_PERMISSION;
     }
-    std::lock_guard<std::mutex> lock(authStateMutex_);
-    auto iter = authStateInfo.find(userId);
-    if (iter != authStateInfo.end()) {
-        iter->second = authState;
-        return E_SCREENLOCK_OK;
+    {
+        std::lock_guard<std::mutex> lock(authStateMutex_);
+        authStateInfo[userId] = authState;
     }
-    authStateInfo.insert(std::make_pair(userId, authState));
+    // Persisted as a hint for diagnosis only, a restarted service starts every user from UNAUTH.
+    int64_t now = GetWallTimeMs();
+    UpdateUserState(userId, [authState, now](UserStateRecord &record) {
+        record.authState = authState;
+        record.authUpdateTime = now;
+    });
     return E_SCREENLOCK_OK;
 }
 
@@ -613,6 +1008,87 @@ int32_t ScreenLockSystemAbility::GetStrongAuth(int userId, int32_t &reasonFlag)
     return E_SCREENLOCK_OK;
 }
 
+int32_t ScreenLockSystemAbility::GetSharedState(sptr<Ashmem> &ashmem, bool &isLockQueryAllowed)
+{
+    ashmem = stateValue_.GetSharedStateAshmem();
+    if (ashmem == nullptr) {
+        SCLOCK_HILOGE("shared state is not ready");
+        return E_SCREENLOCK_NULLPTR;
+    }
+    AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    auto tokenType = AccessTokenKit::GetTokenTypeFlag(callerToken);
+    isLockQueryAllowed = tokenType != TOKEN_HAP || IsSystemApp();
+    return E_SCREENLOCK_OK;
+}
+
+int32_t ScreenLockSystemAbility::GetStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot)
+{
+    SCLOCK_HILOGD("GetStateSnapshot userId=%{public}d", userId);
+    AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    auto tokenType = AccessTokenKit::GetTokenTypeFlag(callerToken);
+    if (tokenType == TOKEN_HAP && !IsSystemApp()) {
+        SCLOCK_HILOGE("Calling app is not system app");
+        return E_SCREENLOCK_NOT_SYSTEM_APP;
+    }
+    if (!CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK")) {
+        SCLOCK_HILOGE("no permission: userId=%{public}d", userId);
+        return E_SCREENLOCK_NO_PERMISSION;
+    }
+    return FillStateSnapshot(userId, snapshot);
+}
+
+int32_t ScreenLockSystemAbility::FillStateSnapshot(int32_t userId, ScreenLockStateSnapshot &snapshot)
+{
+    if (!GetUserDisabled(userId, snapshot.isDisabled)) {
+        return E_SCREENLOCK_NULLPTR;
+    }
+    snapshot.version = STATE_SNAPSHOT_VERSION;
+    snapshot.isLocked = stateValue_.GetScreenlockedState();
+    snapshot.isSecure = IsUserSecure(userId);
+    {
+        std::lock_guard<std::mutex> lock(authStateMutex_);
+        auto iter = authStateInfo.find(userId);
+        snapshot.authState =
+            iter != authStateInfo.end() ? iter->second : static_cast<int32_t>(AuthState::UNAUTH);
+    }
+    snapshot.strongAuthReason = StrongAuthManger::GetInstance()->GetStrongAuthStat(userId);
+    return E_SCREENLOCK_OK;
+}
+
+int32_t ScreenLockSystemAbility::GetMissedEvents(uint64_t epoch, uint64_t lastSeq, ScreenLockEventResync &resync,
+    std::vector<SystemEvent> &events)
+{
+    AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    if (AccessTokenKit::GetTokenTypeFlag(callerToken) == TOKEN_HAP && !IsSystemApp()) {
+        SCLOCK_HILOGE("Calling app is not system app");
+        return E_SCREENLOCK_NOT_SYSTEM_APP;
+    }
+    if (!CheckPermission("ohos.permission.ACCESS_SCREEN_LOCK_INNER")) {
+        return E_SCREENLOCK_NO_PERMISSION;
+    }
+    events.clear();
+    resync.epoch = eventBus_.GetEpoch();
+    if (epoch == resync.epoch && eventBus_.GetEventsSince(lastSeq, events)) {
+        resync.isFullSync = false;
+        resync.latestSeq = events.empty() ? lastSeq : events.back().seq_;
+        SCLOCK_HILOGD("GetMissedEvents lastSeq=%{public}" PRIu64 ", count=%{public}zu", lastSeq, events.size());
+        return E_SCREENLOCK_OK;
+    }
+    events.clear();
+    // Read before the state, so events racing with this call are replayed by the next resync.
+    resync.latestSeq = eventBus_.GetLatestSeq();
+    SCLOCK_HILOGI("GetMissedEvents full sync, lastSeq=%{public}" PRIu64, lastSeq);
+    resync.isFullSync = true;
+    resync.currentUser = stateValue_.GetCurrentUser();
+    if (resync.currentUser == USER_NULL) {
+        // Not published until the account service is up, ask it directly.
+        resync.currentUser = GetCurrentActiveOsAccountId();
+    }
+    resync.screenState = stateValue_.GetScreenState();
+    resync.interactiveState = stateValue_.GetInteractiveState();
+    return FillStateSnapshot(resync.currentUser, resync.snapshot);
+}
+
 void ScreenLockSystemAbility::SetScreenlocked(bool isScreenlocked)
 {
     SCLOCK_HILOGI("ScreenLockSystemAbility SetScreenlocked state:%{public}d.", isScreenlocked);
@@ -623,7 +1099,52 @@ void StateValue::Reset()
 {
     isScreenlocked_ = false;
     screenlockEnabled_ = true;
-    currentUser_ = USER_NULL;
+    // currentUser_ follows the foreground account rather than the lock app, so it survives a reset.
+    PublishSharedState();
+}
+
+bool StateValue::InitSharedState()
+{
+    {
+        std::lock_guard<std::mutex> lock(sharedStateMutex_);
+        if (sharedState_ != nullptr) {
+            return true;
+        }
+        auto sharedState = std::make_shared<ScreenLockSharedState>();
+        if (!sharedState->Create()) {
+            return false;
+        }
+        sharedState_ = sharedState;
+    }
+    PublishSharedState();
+    return true;
+}
+
+sptr<Ashmem> StateValue::GetSharedStateAshmem()
+{
+    std::lock_guard<std::mutex> lock(sharedStateMutex_);
+    if (sharedState_ == nullptr) {
+        return nullptr;
+    }
+    return sharedState_->GetAshmem();
+}
+
+void StateValue::PublishSharedState()
+{
+    // Fields are sampled under the lock so the last publisher always writes the latest values.
+    std::lock_guard<std::mutex> lock(sharedStateMutex_);
+    if (sharedState_ == nullptr) {
+        return;
+    }
+    SharedStateSnapshot snapshot;
+    snapshot.isScreenlocked = isScreenlocked_;
+    snapshot.screenState = screenState_;
+    snapshot.interactiveState = interactiveState_;
+    snapshot.currentUser = currentUser_;
+    snapshot.offReason = offReason_;
+    snapshot.credentialTracked = credentialTracked_;
+    snapshot.credentialEpoch = credentialEpoch_;
+    sharedState_->Write(snapshot);
 }
 
 int ScreenLockSystemAbility::Dump(int fd, const std::vector<std::u16string> &args)
@@ -661,9 +1182,66 @@ void ScreenLockSystemAbility::RegisterDumpCommand()
                 .append(" * offReason  \t\t\t" + std::to_string(offReason) + "\t\tscreen failure reason\n")
                 .append(" * interactiveState \t\t" + std::to_string(interactiveState) +
                 "\t\tscreen interaction status\n");
+            unlockListeners_.Dump(output);
+            lockListeners_.Dump(output);
+            DumpUserStore(output);
             return true;
         });
     DumpHelper::GetInstance().RegisterCommand(cmd);
+    auto ipcCmd = std::make_shared<Command>(std::vector<std::string>{ "-ipc" },
+        "dump ipc call, permission cache and event subscriber statistics",
+        [this](const std::vector<std::string> &input, std::string &output) -> bool {
+            DumpIpcStats(output);
+            PermissionCache::GetInstance()->Dump(output);
+            eventBus_.Dump(output);
+            output.append(" * lock app listener\tseq:" + std::to_string(eventBus_.GetLatestSeq()))
+                .append("\tcoalesced:" + std::to_string(coalescedEvents_.load()) + "\n");
+            return true;
+        });
+    DumpHelper::GetInstance().RegisterCommand(ipcCmd);
+    auto latencyCmd = std::make_shared<Command>(std::vector<std::string>{ "-latency" },
+        "dump system event and lock/unlock latency histograms",
+        [this](const std::vector<std::string> &input, std::string &output) -> bool {
+            DumpLatency(output);
+            return true;
+        });
+    DumpHelper::GetInstance().RegisterCommand(latencyCmd);
+}
+
+void ScreenLockSystemAbility::DumpUserStore(std::string &output)
+{
+    if (!userStore_.IsValid()) {
+        output.append(" * user store\t\t\tunavailable\n");
+        return;
+    }
+    userStore_.Dump(output);
+    for (const auto &record : userStore_.GetAll()) {
+        output.append(" * user " + std::to_string(record.userId))
+            .append("\tdisabled:" + std::to_string(record.isDisabled))
+            .append("\tauthState:" + std::to_string(record.authState))
+            .append("\tstrongAuth:" + std::to_string(record.strongAuthReason))
+            .append("\tauthTime:" + std::to_string(record.authUpdateTime) + "\n");
+    }
+}
+
+void ScreenLockSystemAbility::DumpLatency(std::string &output)
+{
+    // wait: ingress to dequeue by a drain task, send: dequeue to the one-way send returning. The send does
+    // not wait for the lock app, so its handling of the event is not included.
+    output.append("\n System event latency\n");
+    for (size_t index = 0; index < eventLatency_.size(); index++) {
+        std::string eventType = GetSystemEventName(static_cast<SystemEventId>(index));
+        eventType = eventType.empty() ? "unknown" : eventType;
+        const EventLatency &latency = eventLatency_[index];
+        latency.queueWait.Dump(eventType + " wait", output);
+        latency.send.Dump(eventType + " send", output);
+    }
+    output.append("\n Keyguard drawn latency\n");
+    wakeToDrawn_.Dump("wake up to drawn", output);
+    keyguardDrawnNotify_.Dump("drawn to display notified", output);
+    output.append("\n Lock/unlock result latency\n");
+    unlockListeners_.DumpLatency(output);
+    lockListeners_.DumpLatency(output);
 }
 
 void ScreenLockSystemAbility::PublishEvent(const std::string &eventAction)
@@ -681,17 +1259,7 @@ void ScreenLockSystemAbility::LockScreenEvent(int stateResult)
     if (stateResult == ScreenChange::SCREEN_SUCC) {
         SetScreenlocked(true);
     }
-    std::lock_guard<std::mutex> autoLock(lockListenerMutex_);
-    if (lockVecListeners_.size()) {
-        auto callback = [this, stateResult]() {
-            std::lock_guard<std::mutex> guard(lockListenerMutex_);
-            for (size_t i = 0; i < lockVecListeners_.size(); i++) {
-                lockVecListeners_[i]->OnCallBack(stateResult);
-            }
-            lockVecListeners_.clear();
-        };
-        ffrt::submit(callback);
-    }
+    lockListeners_.NotifyAll(stateResult);
     if (stateResult == ScreenChange::SCREEN_SUCC) {
         PublishEvent(EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_LOCKED);
     }
@@ -713,42 +1281,113 @@ void ScreenLockSystemAbility::UnlockScreenEvent(int stateResult)
 
 void ScreenLockSystemAbility::SystemEventCallBack(const SystemEvent &systemEvent, TraceTaskId traceTaskId)
 {
-    SCLOCK_HILOGI("eventType is %{public}s, params is %{public}s", systemEvent.eventType_.c_str(),
-        systemEvent.params_.c_str());
-    if (systemEventListener_ == nullptr) {
-        SCLOCK_HILOGE("systemEventListener_ is nullptr.");
+    auto ingressTime = std::chrono::steady_clock::now();
+    SystemEvent event = systemEvent;
+    bool isCritical = IsCriticalEvent(event.eventId_);
+    size_t coalesced = 0;
+    {
+        // Held across Publish, so the lock app stream takes events in the order their seq was assigned.
+        std::lock_guard<std::mutex> lock(pendingEventMutex_);
+        event.seq_ = eventBus_.Publish(event);
+        SCLOCK_HILOGI("eventType is %{public}s, params is %{public}s, seq is %{public}" PRIu64,
+            event.GetEventType().c_str(), event.params_.c_str(), event.seq_);
+        if (systemEventListener_ == nullptr) {
+            SCLOCK_HILOGE("systemEventListener_ is nullptr.");
+            return;
+        }
+        if (queue_ == nullptr) {
+            return;
+        }
+        if (isCritical) {
+            pendingCriticalEvents_.push_back({ event, traceTaskId, ingressTime });
+        } else {
+            size_t pendingCount = pendingSystemEvents_.size();
+            pendingSystemEvents_.erase(std::remove_if(pendingSystemEvents_.begin(), pendingSystemEvents_.end(),
+                [&event](const PendingSystemEvent &pending) {
+                    return ScreenLockEventBus::Supersedes(event, pending.systemEvent);
+                }),
+                pendingSystemEvents_.end());
+            coalesced = pendingCount - pendingSystemEvents_.size();
+            pendingSystemEvents_.push_back({ event, traceTaskId, ingressTime });
+        }
+    }
+    coalescedEvents_ += coalesced;
+    if (isCritical) {
+        // Delivered ahead of the queued informational events, by whichever drain task gets there first.
+        ffrt::submit([this]() { DeliverPendingSystemEvents(); }, {}, {},
+            ffrt::task_attr().qos(ffrt::qos_user_initiated));
         return;
     }
-    auto callback = [this, systemEvent, traceTaskId]() {
-        if (traceTaskId != HITRACE_BUTT) {
-            StartAsyncTrace(HITRACE_TAG_MISC, "ScreenLockSystemAbility::" + systemEvent.eventType_ + "begin callback",
-                traceTaskId);
-        }
+    if (coalesced > 0) {
+        // The superseded event's task is still queued and will deliver this one instead.
+        return;
+    }
+    queue_->submit([this]() { DeliverPendingSystemEvents(); });
+}
+
+bool ScreenLockSystemAbility::IsCriticalEvent(SystemEventId eventId)
+{
+    return eventId == SystemEventId::LOCKSCREEN || eventId == SystemEventId::UNLOCKSCREEN ||
+        eventId == SystemEventId::STRONG_AUTH_CHANGED;
+}
+
+void ScreenLockSystemAbility::DeliverPendingSystemEvents()
+{
+    // One task delivers at a time; a task waiting here is suspended without holding an ffrt worker.
+    std::lock_guard<ffrt::mutex> deliveryLock(deliveryMutex_);
+    PendingSystemEvent pending;
+    while (TakeNextSystemEvent(pending)) {
+        DeliverSystemEvent(pending);
+    }
+}
+
+bool ScreenLockSystemAbility::TakeNextSystemEvent(PendingSystemEvent &pending)
+{
+    std::lock_guard<std::mutex> lock(pendingEventMutex_);
+    auto &events = pendingCriticalEvents_.empty() ? pendingSystemEvents_ : pendingCriticalEvents_;
+    if (events.empty()) {
+        return false;
+    }
+    pending = events.front();
+    events.pop_front();
+    return true;
+}
+
+void ScreenLockSystemAbility::DeliverSystemEvent(const PendingSystemEvent &pending)
+{
+    auto dequeueTime = std::chrono::steady_clock::now();
+    const SystemEvent &systemEvent = pending.systemEvent;
+    TraceTaskId traceTaskId = pending.traceTaskId;
+    if (traceTaskId != HITRACE_BUTT) {
+        StartAsyncTrace(HITRACE_TAG_MISC, "ScreenLockSystemAbility::" + systemEvent.GetEventType() + "begin callback",
+            traceTaskId);
+    }
+    {
         std::lock_guard<std::mutex> lck(listenerMutex_);
-        systemEventListener_->OnCallBack(systemEvent);
-        if (traceTaskId != HITRACE_BUTT) {
-            FinishAsyncTrace(HITRACE_TAG_MISC, "ScreenLockSystemAbility::" + systemEvent.eventType_ + "end callback",
-                traceTaskId);
+        if (systemEventListener_ != nullptr) {
+            systemEventListener_->OnCallBack(systemEvent);
+            // One-way delivery cannot report a dead listener, drop it so later events skip the binder call.
+            auto remote = systemEventListener_->AsObject();
+            if (remote != nullptr && remote->IsObjectDead()) {
+                SCLOCK_HILOGW("systemEventListener_ is dead, drop it.");
+                systemEventListener_ = nullptr;
+            }
         }
-    };
-    if (queue_ != nullptr) {
-        queue_->submit(callback);
+    }
+    auto eventIndex = static_cast<size_t>(systemEvent.eventId_);
+    if (eventIndex < eventLatency_.size()) {
+        eventLatency_[eventIndex].queueWait.Record(dequeueTime - pending.ingressTime);
+        eventLatency_[eventIndex].send.Record(std::chrono::steady_clock::now() - dequeueTime);
+    }
+    if (traceTaskId != HITRACE_BUTT) {
+        FinishAsyncTrace(HITRACE_TAG_MISC, "ScreenLockSystemAbility::" + systemEvent.GetEventType() + "end callback",
+            traceTaskId);
     }
 }
 
 void ScreenLockSystemAbility::NotifyUnlockListener(const int32_t screenLockResult)
 {
-    std::lock_guard<std::mutex> autoLock(unlockListenerMutex_);
-    if (unlockVecListeners_.size()) {
-        auto callback = [this, screenLockResult]() {
-            std::lock_guard<std::mutex> guard(unlockListenerMutex_);
-            for (size_t i = 0; i < unlockVecListeners_.size(); i++) {
-                unlockVecListeners_[i]->OnCallBack(screenLockResult);
-            }
-            unlockVecListeners_.clear();
-        };
-        ffrt::submit(callback);
-    }
+    unlockListeners_.NotifyAll(screenLockResult);
 }
 
 void ScreenLockSystemAbility::NotifyDisplayEvent(DisplayEvent event)
@@ -758,7 +1397,23 @@ void ScreenLockSystemAbility::NotifyDisplayEvent(DisplayEvent event)
         return;
     }
     auto callback = [event]() { DisplayManager::GetInstance().NotifyDisplayEvent(event); };
-    queue_->submit(callback);
+    ffrt::submit(callback, {}, {}, ffrt::task_attr().qos(ffrt::qos_user_initiated));
+}
+
+void ScreenLockSystemAbility::NotifyKeyguardDrawn()
+{
+    // Display power-on waits for this signal, so it is sent from the calling thread instead of a queue.
+    auto drawnTime = std::chrono::steady_clock::now();
+    DisplayManager::GetInstance().NotifyDisplayEvent(DisplayEvent::KEYGUARD_DRAWN);
+    keyguardDrawnNotify_.Record(std::chrono::steady_clock::now() - drawnTime);
+    int64_t wakeUpTimeNs = wakeUpTimeNs_.exchange(0);
+    if (wakeUpTimeNs <= 0) {
+        return;
+    }
+    auto wakeToDrawn = drawnTime.time_since_epoch() - std::chrono::nanoseconds(wakeUpTimeNs);
+    wakeToDrawn_.Record(wakeToDrawn);
+    SCLOCK_HILOGI("keyguard drawn %{public}" PRId64 " ms after wake up",
+        static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(wakeToDrawn).count()));
 }
 
 void ScreenLockSystemAbility::ResetFfrtQueue()
@@ -771,11 +1426,16 @@ bool ScreenLockSystemAbility::IsAppInForeground(int32_t callingPid, uint32_t cal
 #ifdef CONFIG_FACTORY_MODE
     return true;
 #endif
-    FocusChangeInfo focusInfo;
-    WindowManager::GetInstance().GetFocusWindowInfo(focusInfo);
-    if (callingPid == focusInfo.pid_) {
+    int32_t focusedPid = focusedPid_;
+    if (!focusCacheValid_) {
+        FocusChangeInfo focusInfo;
+        WindowManager::GetInstance().GetFocusWindowInfo(focusInfo);
+        focusedPid = focusInfo.pid_;
+    }
+    if (callingPid == focusedPid) {
         return true;
     }
+    // A focused UIExtension reports its host window, only the ability manager can tell.
     bool isFocused = false;
     std::string identity = IPCSkeleton::ResetCallingIdentity();
     auto ret = AAFwk::AbilityManagerClient::GetInstance()->CheckUIExtensionIsFocused(callingTokenId, isFocused);
@@ -792,8 +1452,7 @@ bool ScreenLockSystemAbility::IsSystemApp()
 bool ScreenLockSystemAbility::CheckPermission(const std::string &permissionName)
 {
     AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
-    int result = AccessTokenKit::VerifyAccessToken(callerToken, permissionName);
-    if (result != PERMISSION_GRANTED) {
+    if (!PermissionCache::GetInstance()->VerifyAccessToken(callerToken, permissionName)) {
         SCLOCK_HILOGE("check permission failed.");
         return false;
     }
@@ -29,12 +29,13 @@ void ScreenLockSystemAbilityProxy::OnCallBack(const SystemEvent &systemEvent)
     SCLOCK_HILOGD("ScreenLockSystemAbilityProxy::OnCallBack Start");
     MessageParcel data;
     MessageParcel reply;
-    MessageOption option;
+    MessageOption option(MessageOption::TF_ASYNC);
     if (!data.WriteInterfaceToken(ScreenLockSystemAbilityProxy::GetDescriptor())) {
         SCLOCK_HILOGE("write descriptor failed");
         return;
     }
-    if (!data.WriteString(systemEvent.eventType_)) {
+    // The name stays first for clients that predate the id, which is appended after the sequence number.
+    if (!data.WriteString(systemEvent.GetEventType())) {
         SCLOCK_HILOGE("write string failed");
         return;
     }
@@ -42,9 +43,17 @@ void ScreenLockSystemAbilityProxy::OnCallBack(const SystemEvent &systemEvent)
         SCLOCK_HILOGE("write string failed");
         return;
     }
+    if (!data.WriteUint64(systemEvent.seq_)) {
+        SCLOCK_HILOGE("write seq failed");
+        return;
+    }
+    if (!data.WriteInt32(static_cast<int32_t>(systemEvent.eventId_))) {
+        SCLOCK_HILOGE("write event id failed");
+        return;
+    }
     int32_t error = Remote()->SendRequest(ON_CALLBACK, data, reply, option);
     if (error != 0) {
-        SCLOCK_HILOGE("SendRequest failed, error %{public}d", error);
+        SCLOCK_HILOGE("SendRequest failed, error %{public}d, isDead: %{public}d", error, Remote()->IsObjectDead());
     }
     SCLOCK_HILOGD("ScreenLockSystemAbilityProxy::OnCallBack End");
 }
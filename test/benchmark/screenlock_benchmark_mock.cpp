@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Stand-ins for the access token and account services. They are linked into the benchmark
+// executable and take precedence over the shared library symbols, so every request runs the
+// service logic without any system service behind it.
+
+#include "accesstoken_kit.h"
+#include "os_account_manager.h"
+#include "screenlock_benchmark_mock.h"
+#include "tokenid_kit.h"
+
+namespace OHOS {
+namespace Security {
+namespace AccessToken {
+int AccessTokenKit::VerifyAccessToken(AccessTokenID tokenID, const std::string &permissionName)
+{
+    return PERMISSION_GRANTED;
+}
+
+ATokenTypeEnum AccessTokenKit::GetTokenTypeFlag(AccessTokenID tokenID)
+{
+    return TOKEN_NATIVE;
+}
+
+int32_t AccessTokenKit::RegisterPermStateChangeCallback(
+    const std::shared_ptr<PermStateChangeCallbackCustomize> &callback)
+{
+    return RET_SUCCESS;
+}
+
+int32_t AccessTokenKit::UnRegisterPermStateChangeCallback(
+    const std::shared_ptr<PermStateChangeCallbackCustomize> &callback)
+{
+    return RET_SUCCESS;
+}
+
+bool TokenIdKit::IsSystemAppByFullTokenID(uint64_t tokenId)
+{
+    return true;
+}
+} // namespace AccessToken
+} // namespace Security
+
+namespace AccountSA {
+ErrCode OsAccountManager::GetOsAccountLocalIdFromUid(const int uid, int &id)
+{
+    id = ScreenLock::BENCHMARK_USER_ID;
+    return ERR_OK;
+}
+
+ErrCode OsAccountManager::GetForegroundOsAccountLocalId(int32_t &localId)
+{
+    localId = ScreenLock::BENCHMARK_USER_ID;
+    return ERR_OK;
+}
+
+ErrCode OsAccountManager::QueryActiveOsAccountIds(std::vector<int32_t> &ids)
+{
+    ids = { ScreenLock::BENCHMARK_USER_ID };
+    return ERR_OK;
+}
+} // namespace AccountSA
+} // namespace OHOS
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_BENCHMARK_MOCK_H
+#define SCREENLOCK_BENCHMARK_MOCK_H
+
+#include <cstdint>
+
+namespace OHOS {
+namespace ScreenLock {
+constexpr int32_t BENCHMARK_USER_ID = 100;
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_BENCHMARK_MOCK_H
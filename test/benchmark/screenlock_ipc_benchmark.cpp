@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define private public
+#define protected public
+#include "permission_cache.h"
+#include "screenlock_system_ability.h"
+#undef private
+#undef protected
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "message_parcel.h"
+#include "screenlock_benchmark_mock.h"
+#include "screenlock_callback_stub.h"
+#include "screenlock_common.h"
+#include "screenlock_server_ipc_interface_code.h"
+#include "screenlock_system_ability_stub.h"
+
+using namespace OHOS;
+using namespace OHOS::ScreenLock;
+
+namespace {
+const std::u16string SCREENLOCK_MANAGER_INTERFACE_TOKEN = u"ohos.screenlock.ScreenLockManagerInterface";
+constexpr int32_t DEFAULT_ITERATIONS = 2000;
+constexpr int32_t WARMUP_ITERATIONS = 100;
+constexpr double PERCENTILE_50 = 0.50;
+constexpr double PERCENTILE_99 = 0.99;
+constexpr double NS_PER_US = 1000.0;
+constexpr double NS_PER_SECOND = 1e9;
+constexpr int32_t AUTH_STATE = 1;
+
+using Code = ScreenLockServerIpcInterfaceCode;
+using DataWriter = std::function<void(MessageParcel &data)>;
+
+struct BenchmarkResult {
+    std::string name;
+    uint32_t code = 0;
+    double opsPerSecond = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+};
+
+sptr<ScreenLockCallbackStub> g_callback = new ScreenLockCallbackStub();
+sptr<ScreenLockSystemAbilityStub> g_systemEventListener = new ScreenLockSystemAbilityStub();
+
+void WriteCallback(MessageParcel &data)
+{
+    data.WriteRemoteObject(g_callback->AsObject());
+}
+
+void WriteSystemEventListener(MessageParcel &data)
+{
+    data.WriteRemoteObject(g_systemEventListener->AsObject());
+}
+
+void WriteUserId(MessageParcel &data)
+{
+    data.WriteInt32(BENCHMARK_USER_ID);
+}
+
+// Payloads mirror the proxy side; codes not listed here are sent with an empty body.
+const std::map<Code, DataWriter> DATA_WRITERS = {
+    { Code::UNLOCK_SCREEN, WriteCallback },
+    { Code::UNLOCK, WriteCallback },
+    { Code::LOCK, WriteCallback },
+    { Code::ONSYSTEMEVENT, WriteSystemEventListener },
+    // A cancelled unlock result stays inside the service, SCREEN_DRAWDONE would time a real DisplayManager call.
+    { Code::SEND_SCREENLOCK_EVENT,
+        [](MessageParcel &data) {
+            data.WriteString(UNLOCK_SCREEN_RESULT);
+            data.WriteInt32(ScreenChange::SCREEN_CANCEL);
+        } },
+    { Code::LOCK_SCREEN, WriteUserId },
+    { Code::IS_SCREENLOCK_DISABLED, WriteUserId },
+    { Code::SET_SCREENLOCK_DISABLED,
+        [](MessageParcel &data) {
+            data.WriteBool(false);
+            data.WriteInt32(BENCHMARK_USER_ID);
+        } },
+    { Code::SET_SCREENLOCK_AUTHSTATE,
+        [](MessageParcel &data) {
+            data.WriteInt32(AUTH_STATE);
+            data.WriteInt32(BENCHMARK_USER_ID);
+            data.WriteString("");
+        } },
+    { Code::GET_SCREENLOCK_AUTHSTATE, WriteUserId },
+    { Code::REQUEST_STRONG_AUTHSTATE,
+        [](MessageParcel &data) {
+            data.WriteInt32(0);
+            data.WriteInt32(BENCHMARK_USER_ID);
+        } },
+    { Code::GET_STRONG_AUTHSTATE, WriteUserId },
+    { Code::GET_STATE_SNAPSHOT, WriteUserId },
+    { Code::SUBSCRIBE_SYSTEM_EVENT,
+        [](MessageParcel &data) {
+            WriteSystemEventListener(data);
+            data.WriteStringVector({ END_SCREEN_ON });
+        } },
+    { Code::UNSUBSCRIBE_SYSTEM_EVENT, WriteSystemEventListener },
+};
+
+void SeedUserState(sptr<ScreenLockSystemAbility> &service)
+{
+    service->stateValue_.SetCurrentUser(BENCHMARK_USER_ID);
+    service->stateValue_.SetCredentialTracked(true);
+    // Stands in for UserIAM, every secure query answers from the credential cache.
+    std::lock_guard<std::mutex> lock(service->secureCacheMutex_);
+    service->secureCache_[BENCHMARK_USER_ID] = true;
+}
+
+void PrepareService(sptr<ScreenLockSystemAbility> &service)
+{
+    ScreenLockSystemAbility::queue_ = std::make_shared<ffrt::queue>("ScreenLockBenchmark");
+    service->stateValue_.InitSharedState();
+    service->systemReady_ = true;
+    SeedUserState(service);
+    PermissionCache::GetInstance()->RegisterPermStateChangeCallback();
+}
+
+void ResetService(sptr<ScreenLockSystemAbility> &service)
+{
+    service->unlockListeners_.TakeAll();
+    service->lockListeners_.TakeAll();
+    // Requests such as ONSYSTEMEVENT reset the state, seed it again so no request reaches UserIAM.
+    SeedUserState(service);
+}
+
+double Percentile(const std::vector<int64_t> &sortedCosts, double percentile)
+{
+    size_t index = static_cast<size_t>(percentile * (sortedCosts.size() - 1));
+    return sortedCosts[index] / NS_PER_US;
+}
+
+BenchmarkResult RunCode(sptr<ScreenLockSystemAbility> &service, uint32_t code, int32_t iterations)
+{
+    DataWriter writer = nullptr;
+    auto iter = DATA_WRITERS.find(static_cast<Code>(code));
+    if (iter != DATA_WRITERS.end()) {
+        writer = iter->second;
+    }
+    std::vector<int64_t> costs;
+    costs.reserve(iterations);
+    int64_t totalNs = 0;
+    for (int32_t i = -WARMUP_ITERATIONS; i < iterations; i++) {
+        MessageParcel data;
+        data.WriteInterfaceToken(SCREENLOCK_MANAGER_INTERFACE_TOKEN);
+        if (writer != nullptr) {
+            writer(data);
+        }
+        MessageParcel reply;
+        MessageOption option;
+        auto begin = std::chrono::steady_clock::now();
+        service->OnRemoteRequest(code, data, reply, option);
+        auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+        ResetService(service);
+        if (i < 0) {
+            continue;
+        }
+        costs.push_back(cost.count());
+        totalNs += cost.count();
+    }
+    std::sort(costs.begin(), costs.end());
+    BenchmarkResult result;
+    result.name = ScreenLockManagerStub::handleTable_[code].name;
+    result.code = code;
+    result.opsPerSecond = totalNs > 0 ? iterations * NS_PER_SECOND / totalNs : 0;
+    result.p50Us = Percentile(costs, PERCENTILE_50);
+    result.p99Us = Percentile(costs, PERCENTILE_99);
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int32_t iterations = DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = std::max(1, atoi(argv[1]));
+    }
+    auto service = ScreenLockSystemAbility::GetInstance();
+    PrepareService(service);
+
+    printf("%-28s %6s %14s %12s %12s\n", "IPC code", "Code", "Ops/sec", "p50(us)", "p99(us)");
+    constexpr uint32_t codeCount = static_cast<uint32_t>(Code::SCREENLOCK_IPC_CODE_BUTT);
+    for (uint32_t code = 0; code < codeCount; code++) {
+        if (ScreenLockManagerStub::handleTable_[code].func == nullptr) {
+            continue;
+        }
+        BenchmarkResult result = RunCode(service, code, iterations);
+        printf("%-28s %6u %14.0f %12.2f %12.2f\n", result.name.c_str(), result.code, result.opsPerSecond,
+            result.p50Us, result.p99Us);
+    }
+    PermissionCache::GetInstance()->UnRegisterPermStateChangeCallback();
+    ScreenLockSystemAbility::GetInstance()->ResetFfrtQueue();
+    return 0;
+}
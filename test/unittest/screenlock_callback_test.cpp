@@ -29,7 +29,8 @@ ScreenLockSystemAbilityTest::~ScreenLockSystemAbilityTest()
 
 void ScreenLockSystemAbilityTest::OnCallBack(const SystemEvent &systemEvent)
 {
-    SCLOCK_HILOGD("event=%{public}s,params=%{public}s", systemEvent.eventType_.c_str(), systemEvent.params_.c_str());
+    SCLOCK_HILOGD("event=%{public}s,params=%{public}s", systemEvent.GetEventType().c_str(),
+        systemEvent.params_.c_str());
 }
 
 ScreenlockCallbackTest::ScreenlockCallbackTest(const EventListenerTest &eventListener)
@@ -333,5 +333,101 @@ HWTEST_F(ScreenLockClientTest, LockTest0015, TestSize.Level0)
     SCLOCK_HILOGD("GetStrongAuth.[result]:%{public}d", result);
 }
 
+/**
+* @tc.name: GetSecureTest0016
+* @tc.desc: Test GetSecure with the state cache enabled.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockClientTest, GetSecureTest0016, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test GetSecure with state cache.");
+    auto manager = ScreenLockManager::GetInstance();
+    bool uncached = manager->GetSecure();
+    manager->EnableStateCache(true);
+    EXPECT_EQ(manager->GetSecure(), uncached);
+    EXPECT_EQ(manager->GetSecure(), uncached);
+    manager->EnableStateCache(false);
+    EXPECT_FALSE(manager->secureCache_.isValid);
+}
+
+/**
+* @tc.name: GetStateSnapshotTest0017
+* @tc.desc: Test GetStateSnapshot returns the same facts as the single queries.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockClientTest, GetStateSnapshotTest0017, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test GetStateSnapshot.");
+    int32_t userId = 0;
+    ScreenLockStateSnapshot snapshot;
+    int32_t result = ScreenLockAppManager::GetInstance()->GetStateSnapshot(userId, snapshot);
+    SCLOCK_HILOGD("GetStateSnapshot.[result]:%{public}d", result);
+    if (result == E_SCREENLOCK_OK) {
+        EXPECT_EQ(snapshot.version, STATE_SNAPSHOT_VERSION);
+        int32_t reasonFlag = 0;
+        ScreenLockAppManager::GetInstance()->GetStrongAuth(userId, reasonFlag);
+        EXPECT_EQ(snapshot.strongAuthReason, reasonFlag);
+    }
+}
+
+/**
+* @tc.name: GetMissedEventsTest0018
+* @tc.desc: Test GetMissedEvents falls back to a full sync for an unknown epoch and replays deltas otherwise.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockClientTest, GetMissedEventsTest0018, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test GetMissedEvents.");
+    ScreenLockEventResync resync;
+    std::vector<SystemEvent> events;
+    int32_t result = ScreenLockAppManager::GetInstance()->GetMissedEvents(0, 0, resync, events);
+    SCLOCK_HILOGD("GetMissedEvents.[result]:%{public}d", result);
+    if (result != E_SCREENLOCK_OK) {
+        return;
+    }
+    EXPECT_TRUE(resync.isFullSync);
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(resync.snapshot.version, STATE_SNAPSHOT_VERSION);
+
+    ScreenLockEventResync delta;
+    result = ScreenLockAppManager::GetInstance()->GetMissedEvents(resync.epoch, resync.latestSeq, delta, events);
+    EXPECT_EQ(result, E_SCREENLOCK_OK);
+    EXPECT_EQ(delta.epoch, resync.epoch);
+    for (const auto &event : events) {
+        EXPECT_GT(event.seq_, resync.latestSeq);
+    }
+}
+
+/**
+* @tc.name: GetSecureTest0019
+* @tc.desc: Test the GetSecure cache misses once the shared state reports another user.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockClientTest, GetSecureTest0019, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test GetSecure cache after a user switch.");
+    auto manager = ScreenLockManager::GetInstance();
+    bool uncached = manager->GetSecure();
+    manager->EnableStateCache(true);
+    EXPECT_EQ(manager->GetSecure(), uncached);
+    if (manager->secureCache_.isValid) {
+        // Pretend the cached answer was taken for the previous foreground user.
+        constexpr int32_t previousUserOffset = 1;
+        std::lock_guard<std::mutex> autoLock(manager->secureCacheLock_);
+        manager->secureCache_.currentUser += previousUserOffset;
+        manager->secureCache_.isSecure = !uncached;
+    }
+    EXPECT_EQ(manager->GetSecure(), uncached);
+    manager->EnableStateCache(false);
+}
+
 } // namespace ScreenLock
 } // namespace OHOS
\ No newline at end of file
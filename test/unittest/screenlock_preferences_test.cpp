@@ -183,6 +183,71 @@ HWTEST_F(ScreenLockPreferenceTest, ScreenLockPreferenceTest006, TestSize.Level0)
     preferencesUtil->RefreshSync();
 }
 
+/**
+* @tc.name: ScreenLockPreferenceTest007
+* @tc.desc: ScreenLockPreferenceTest reads see cached writes before and after the flush.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockPreferenceTest, ScreenLockPreferenceTest007, TestSize.Level0)
+{
+    SCLOCK_HILOGD("ScreenLockPreferenceTest Cache");
+    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+    ASSERT_NE(preferencesUtil, nullptr);
+    const std::string key = std::to_string(1001);
+    constexpr int32_t writeCount = 10;
+    for (int32_t i = 0; i < writeCount; i++) {
+        EXPECT_EQ(preferencesUtil->SaveBool(key, i % 2 == 0), NativePreferences::E_OK);
+    }
+    EXPECT_FALSE(preferencesUtil->ObtainBool(key, true));
+    EXPECT_TRUE(preferencesUtil->IsExistKey(key));
+    EXPECT_EQ(preferencesUtil->RefreshSync(), NativePreferences::E_OK);
+    EXPECT_FALSE(preferencesUtil->ObtainBool(key, true));
+
+    preferencesUtil->RemoveKey(key);
+    EXPECT_FALSE(preferencesUtil->IsExistKey(key));
+    EXPECT_TRUE(preferencesUtil->ObtainBool(key, true));
+    EXPECT_EQ(preferencesUtil->RefreshSync(), NativePreferences::E_OK);
+}
+
+/**
+* @tc.name: ScreenLockPreferenceTest008
+* @tc.desc: ScreenLockPreferenceTest transaction applies staged changes only on commit.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockPreferenceTest, ScreenLockPreferenceTest008, TestSize.Level0)
+{
+    SCLOCK_HILOGD("ScreenLockPreferenceTest Transaction");
+    auto preferencesUtil = DelayedSingleton<PreferencesUtil>::GetInstance();
+    ASSERT_NE(preferencesUtil, nullptr);
+    const std::string boolKey = std::to_string(1002);
+    const std::string intKey = std::to_string(1003);
+    {
+        PreferencesUtil::Transaction transaction(*preferencesUtil);
+        transaction.SaveBool(boolKey, true);
+        EXPECT_TRUE(transaction.ObtainBool(boolKey, false));
+    }
+    EXPECT_FALSE(preferencesUtil->IsExistKey(boolKey));
+    {
+        PreferencesUtil::Transaction transaction(*preferencesUtil);
+        transaction.SaveBool(boolKey, true);
+        transaction.SaveInt(intKey, 1);
+        EXPECT_EQ(transaction.Commit(), NativePreferences::E_OK);
+    }
+    EXPECT_TRUE(preferencesUtil->ObtainBool(boolKey, false));
+    EXPECT_EQ(preferencesUtil->ObtainInt(intKey, 0), 1);
+    {
+        PreferencesUtil::Transaction transaction(*preferencesUtil);
+        transaction.RemoveKey(boolKey);
+        transaction.RemoveKey(intKey);
+        EXPECT_EQ(transaction.Commit(), NativePreferences::E_OK);
+    }
+    EXPECT_FALSE(preferencesUtil->IsExistKey(boolKey));
+}
+
 
 } // namespace ScreenLock
 } // namespace OHOS
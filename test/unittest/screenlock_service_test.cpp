@@ -14,16 +14,24 @@
  */
 #define private public
 #define protected public
+#include "latency_histogram.h"
+#include "pending_listener_list.h"
+#include "permission_cache.h"
+#include "screenlock_event_bus.h"
 #include "screenlock_system_ability.h"
+#include "screenlock_user_store.h"
 #undef private
 #undef protected
 
 #include <cstdint>
+#include <cstdio>
 #include <list>
 #include <string>
 #include <sys/time.h>
+#include <thread>
 
 #include "accesstoken_kit.h"
+#include "ipc_skeleton.h"
 #include "sclock_log.h"
 #include "screenlock_callback_test.h"
 #include "screenlock_common.h"
@@ -552,7 +560,7 @@ HWTEST_F(ScreenLockServiceTest, ScreenLockTest026, TestSize.Level0)
 HWTEST_F(ScreenLockServiceTest, ScreenLockTest027, TestSize.Level0)
 {
     SCLOCK_HILOGD("Test UnlockScreenEvent.");
-    ScreenLockSystemAbility::GetInstance()->unlockVecListeners_.clear();
+    ScreenLockSystemAbility::GetInstance()->unlockListeners_.TakeAll();
     ScreenLockSystemAbility::GetInstance()->UnlockScreenEvent(SCREEN_CANCEL);
     bool isLocked;
     ScreenLockSystemAbility::GetInstance()->IsLocked(isLocked);
@@ -650,5 +658,757 @@ HWTEST_F(ScreenLockServiceTest, ScreenLockTest032, TestSize.Level0)
     EXPECT_EQ(result, ERR_OK);
 }
 
+/**
+* @tc.name: ScreenLockTest033
+* @tc.desc: Test shared state page published by the service and read through a read-only mapping.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest033, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test GetSharedState.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    EXPECT_TRUE(service->stateValue_.InitSharedState());
+    sptr<Ashmem> ashmem = nullptr;
+    bool isLockQueryAllowed = false;
+    int32_t ret = service->GetSharedState(ashmem, isLockQueryAllowed);
+    EXPECT_EQ(ret, E_SCREENLOCK_OK);
+
+    ScreenLockSharedState reader;
+    EXPECT_TRUE(reader.Attach(ashmem));
+    SharedStateSnapshot before;
+    EXPECT_TRUE(reader.Read(before));
+
+    service->SetScreenlocked(!before.isScreenlocked);
+    SharedStateSnapshot after;
+    EXPECT_TRUE(reader.Read(after));
+    EXPECT_EQ(after.isScreenlocked, !before.isScreenlocked);
+    EXPECT_GT(after.generation, before.generation);
+    service->SetScreenlocked(before.isScreenlocked);
+}
+
+/**
+* @tc.name: ScreenLockTest034
+* @tc.desc: Test per-code IPC statistics collected by the stub dispatch table.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest034, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test IPC statistics.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    uint32_t code = static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::IS_SCREEN_LOCKED);
+    uint64_t calls = service->ipcStats_[code].calls;
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(ScreenLockManagerStub::GetDescriptor());
+    int32_t ret = service->OnRemoteRequest(code, data, reply, option);
+    EXPECT_EQ(ret, ERR_NONE);
+    EXPECT_EQ(service->ipcStats_[code].calls, calls + 1);
+
+    MessageParcel outOfRangeData;
+    outOfRangeData.WriteInterfaceToken(ScreenLockManagerStub::GetDescriptor());
+    uint32_t outOfRange = static_cast<uint32_t>(ScreenLockServerIpcInterfaceCode::SCREENLOCK_IPC_CODE_BUTT);
+    ret = service->OnRemoteRequest(outOfRange, outOfRangeData, reply, option);
+    EXPECT_NE(ret, ERR_NONE);
+
+    std::string output;
+    service->DumpIpcStats(output);
+    EXPECT_NE(output.find("IS_SCREEN_LOCKED"), std::string::npos);
+}
+
+/**
+* @tc.name: ScreenLockTest035
+* @tc.desc: Test the per-user secure cache is served and dropped on credential updates.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest035, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test secure cache.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    int32_t userId = 100;
+    int32_t otherUserId = 101;
+    service->secureCache_[userId] = true;
+    service->stateValue_.SetCredentialTracked(true);
+    service->secureCache_[otherUserId] = true;
+    EXPECT_TRUE(service->IsUserSecure(userId));
+
+    service->OnCredentialUpdated(std::to_string(userId));
+    EXPECT_EQ(service->secureCache_.count(userId), 0);
+    EXPECT_EQ(service->secureCache_.count(otherUserId), 1);
+
+    service->OnCredentialUpdated("invalid");
+    EXPECT_TRUE(service->secureCache_.empty());
+    service->stateValue_.SetCredentialTracked(false);
+}
+
+/**
+* @tc.name: ScreenLockTest036
+* @tc.desc: Test permission verdicts are cached and dropped on permission state change.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest036, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test permission cache.");
+    auto cache = PermissionCache::GetInstance();
+    bool isCacheEnabled = cache->isCacheEnabled_;
+    cache->isCacheEnabled_ = true;
+    AccessTokenID tokenId = IPCSkeleton::GetCallingTokenID();
+    std::string permission = "ohos.permission.ACCESS_SCREEN_LOCK";
+    bool isGranted = cache->VerifyAccessToken(tokenId, permission);
+    uint64_t hits = cache->hits_;
+    EXPECT_EQ(cache->VerifyAccessToken(tokenId, permission), isGranted);
+    EXPECT_EQ(cache->hits_, hits + 1);
+
+    cache->Invalidate(tokenId, permission);
+    uint64_t misses = cache->misses_;
+    cache->VerifyAccessToken(tokenId, permission);
+    EXPECT_EQ(cache->misses_, misses + 1);
+
+    std::string output;
+    cache->Dump(output);
+    EXPECT_NE(output.find("hits"), std::string::npos);
+    cache->Clear();
+    cache->isCacheEnabled_ = isCacheEnabled;
+}
+
+/**
+* @tc.name: ScreenLockTest037
+* @tc.desc: Test IsAppInForeground answers from the tracked focus state.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest037, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test focus cache.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    bool focusCacheValid = service->focusCacheValid_;
+    int32_t focusedPid = service->focusedPid_;
+    int32_t pid = 12345;
+    service->focusCacheValid_ = true;
+    service->OnFocusChanged(pid, true);
+    EXPECT_TRUE(service->IsAppInForeground(pid, IPCSkeleton::GetCallingTokenID()));
+
+    service->OnFocusChanged(pid, false);
+    EXPECT_EQ(service->focusedPid_, -1);
+    service->focusCacheValid_ = focusCacheValid;
+    service->focusedPid_ = focusedPid;
+}
+
+/**
+* @tc.name: ScreenLockTest038
+* @tc.desc: Test event bus filters by event type and bounds each subscriber queue.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest038, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test event bus.");
+    ScreenLockEventBus eventBus;
+    sptr<ScreenLockSystemAbilityInterface> listener =
+        new (std::nothrow) ScreenLockSystemAbilityTest(g_unlockTestListener);
+    ASSERT_NE(listener, nullptr);
+    EXPECT_EQ(eventBus.Subscribe(nullptr, {}), E_SCREENLOCK_NULLPTR);
+    EXPECT_EQ(eventBus.Subscribe(listener, { END_SCREEN_ON }), E_SCREENLOCK_OK);
+    EXPECT_EQ(eventBus.GetSubscriberCount(), 1);
+
+    auto subscriber = eventBus.subscribers_.begin()->second;
+    // Hold the queue so nothing is drained while counting.
+    subscriber->isDelivering = true;
+    eventBus.Publish(SystemEvent(BEGIN_SLEEP));
+    EXPECT_TRUE(subscriber->pendingEvents.empty());
+    constexpr size_t publishTimes = 70;
+    for (size_t i = 0; i < publishTimes; i++) {
+        eventBus.Publish(SystemEvent(END_SCREEN_ON));
+    }
+    EXPECT_EQ(subscriber->pendingEvents.size(), 64);
+    EXPECT_EQ(subscriber->dropped, publishTimes - 64);
+
+    std::string output;
+    eventBus.Dump(output);
+    EXPECT_NE(output.find("dropped"), std::string::npos);
+    EXPECT_EQ(eventBus.Unsubscribe(listener), E_SCREENLOCK_OK);
+    EXPECT_EQ(eventBus.GetSubscriberCount(), 0);
+}
+
+/**
+* @tc.name: ScreenLockTest039
+* @tc.desc: Test lagging subscribers only keep the latest screen and interactive transition.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest039, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test event coalescing.");
+    EXPECT_TRUE(ScreenLockEventBus::Supersedes(SystemEvent(END_SLEEP), SystemEvent(BEGIN_SLEEP)));
+    EXPECT_TRUE(ScreenLockEventBus::Supersedes(SystemEvent(BEGIN_SCREEN_ON), SystemEvent(END_SCREEN_OFF)));
+    EXPECT_FALSE(ScreenLockEventBus::Supersedes(SystemEvent(END_SCREEN_ON), SystemEvent(END_WAKEUP)));
+    EXPECT_FALSE(ScreenLockEventBus::Supersedes(SystemEvent(LOCKSCREEN), SystemEvent(LOCKSCREEN)));
+
+    ScreenLockEventBus eventBus;
+    sptr<ScreenLockSystemAbilityInterface> listener =
+        new (std::nothrow) ScreenLockSystemAbilityTest(g_unlockTestListener);
+    ASSERT_NE(listener, nullptr);
+    EXPECT_EQ(eventBus.Subscribe(listener, {}), E_SCREENLOCK_OK);
+    auto subscriber = eventBus.subscribers_.begin()->second;
+    subscriber->isDelivering = true;
+    eventBus.Publish(SystemEvent(BEGIN_SLEEP));
+    eventBus.Publish(SystemEvent(LOCKSCREEN));
+    eventBus.Publish(SystemEvent(END_SLEEP));
+    ASSERT_EQ(subscriber->pendingEvents.size(), 2);
+    EXPECT_EQ(subscriber->pendingEvents.front().eventType_, LOCKSCREEN);
+    EXPECT_EQ(subscriber->pendingEvents.back().eventType_, END_SLEEP);
+    EXPECT_EQ(subscriber->coalesced, 1);
+    EXPECT_EQ(eventBus.Unsubscribe(listener), E_SCREENLOCK_OK);
+}
+
+/**
+* @tc.name: ScreenLockTest040
+* @tc.desc: Test event history replays the delta and reports a rolled over ring.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest040, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test event history.");
+    ScreenLockEventBus eventBus;
+    std::vector<SystemEvent> events;
+    EXPECT_TRUE(eventBus.GetEventsSince(0, events));
+    constexpr uint64_t publishTimes = MAX_MISSED_EVENTS + 2;
+    for (uint64_t seq = 1; seq <= publishTimes; seq++) {
+        SystemEvent systemEvent(LOCKSCREEN);
+        systemEvent.seq_ = seq;
+        eventBus.Publish(systemEvent);
+    }
+    EXPECT_TRUE(eventBus.GetEventsSince(publishTimes - 1, events));
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events.front().seq_, publishTimes);
+
+    events.clear();
+    EXPECT_FALSE(eventBus.GetEventsSince(1, events));
+    EXPECT_FALSE(eventBus.GetEventsSince(publishTimes + 1, events));
+}
+
+/**
+* @tc.name: ScreenLockTest041
+* @tc.desc: Test pending listener list rejects requests beyond its capacity.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest041, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test pending listener list.");
+    constexpr size_t capacity = 2;
+    PendingListenerList listeners("test", capacity);
+    EXPECT_EQ(listeners.Add(nullptr), E_SCREENLOCK_NULLPTR);
+    for (size_t i = 0; i < capacity; i++) {
+        sptr<ScreenLockCallbackInterface> listener = new (std::nothrow) ScreenlockCallbackTest(g_unlockTestListener);
+        EXPECT_EQ(listeners.Add(listener), E_SCREENLOCK_OK);
+    }
+    sptr<ScreenLockCallbackInterface> listener = new (std::nothrow) ScreenlockCallbackTest(g_unlockTestListener);
+    EXPECT_EQ(listeners.Add(listener), E_SCREENLOCK_LISTENER_OVERFLOW);
+    EXPECT_EQ(listeners.Size(), capacity);
+
+    std::string output;
+    listeners.Dump(output);
+    EXPECT_NE(output.find("rejected:1"), std::string::npos);
+    EXPECT_EQ(listeners.TakeAll().size(), capacity);
+    EXPECT_EQ(listeners.Size(), 0);
+    EXPECT_EQ(listeners.Add(listener), E_SCREENLOCK_OK);
+}
+
+/**
+* @tc.name: ScreenLockTest042
+* @tc.desc: Test pending listener list hands every listener its own notify task.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest042, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test pending listener notify.");
+    constexpr size_t count = 3;
+    PendingListenerList listeners("test", count);
+    EXPECT_EQ(listeners.NotifyAll(ScreenChange::SCREEN_SUCC), 0);
+    for (size_t i = 0; i < count; i++) {
+        sptr<ScreenLockCallbackInterface> listener = new (std::nothrow) ScreenlockCallbackTest(g_unlockTestListener);
+        EXPECT_EQ(listeners.Add(listener), E_SCREENLOCK_OK);
+    }
+    EXPECT_EQ(listeners.NotifyAll(ScreenChange::SCREEN_SUCC), count);
+    EXPECT_EQ(listeners.Size(), 0);
+    ffrt::wait();
+
+    std::string output;
+    listeners.Dump(output);
+    EXPECT_NE(output.find("notified:3"), std::string::npos);
+}
+
+/**
+* @tc.name: ScreenLockTest043
+* @tc.desc: Test system event ids map to the event names both ways.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest043, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test system event id.");
+    for (int32_t index = 1; index < static_cast<int32_t>(SystemEventId::BUTT); index++) {
+        auto eventId = static_cast<SystemEventId>(index);
+        EXPECT_EQ(GetSystemEventId(GetSystemEventName(eventId)), eventId);
+    }
+    EXPECT_EQ(GetSystemEventId(END_SCREEN_ON), SystemEventId::END_SCREEN_ON);
+    EXPECT_EQ(GetSystemEventId("unknownEvent"), SystemEventId::UNKNOWN);
+    EXPECT_EQ(GetSystemEventName(SystemEventId::BUTT), "");
+
+    SystemEvent byId(SystemEventId::LOCKSCREEN);
+    EXPECT_TRUE(byId.eventType_.empty());
+    EXPECT_EQ(byId.GetEventType(), LOCKSCREEN);
+    SystemEvent byName(SERVICE_RESTART);
+    EXPECT_EQ(byName.eventId_, SystemEventId::SERVICE_RESTART);
+    SystemEvent unknown("unknownEvent");
+    EXPECT_EQ(unknown.GetEventType(), "unknownEvent");
+}
+
+/**
+* @tc.name: ScreenLockTest044
+* @tc.desc: Test SYSTEM_READY waits for both the display listener and the lock app listener.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest044, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test system ready state.");
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    bool systemReady = instance->systemReady_;
+    instance->systemReady_ = false;
+    instance->systemReadyPending_ = true;
+    instance->TryNotifySystemReady();
+    EXPECT_TRUE(instance->systemReadyPending_);
+
+    instance->systemReady_ = true;
+    instance->TryNotifySystemReady();
+    EXPECT_FALSE(instance->systemReadyPending_);
+    instance->systemReady_ = systemReady;
+}
+
+/**
+* @tc.name: ScreenLockTest045
+* @tc.desc: Test latency histogram buckets samples by power of two microseconds.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest045, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test latency histogram.");
+    EXPECT_EQ(LatencyHistogram::GetBucket(0), 0);
+    EXPECT_EQ(LatencyHistogram::GetBucket(1), 1);
+    EXPECT_EQ(LatencyHistogram::GetBucket(3), 2);
+    EXPECT_EQ(LatencyHistogram::GetBucket(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+
+    LatencyHistogram histogram;
+    std::string output;
+    histogram.Dump("empty", output);
+    EXPECT_TRUE(output.empty());
+    histogram.Record(std::chrono::microseconds(3));
+    histogram.Record(std::chrono::microseconds(3));
+    histogram.Record(std::chrono::milliseconds(1));
+    EXPECT_EQ(histogram.GetCount(), 3);
+    EXPECT_EQ(histogram.GetBucketCount(2), 2);
+    histogram.Dump("test", output);
+    EXPECT_NE(output.find("count:3"), std::string::npos);
+    EXPECT_NE(output.find("<4us:2"), std::string::npos);
+
+    output.clear();
+    ScreenLockSystemAbility::GetInstance()->DumpLatency(output);
+    EXPECT_NE(output.find("System event latency"), std::string::npos);
+}
+
+/**
+* @tc.name: ScreenLockTest046
+* @tc.desc: Test requests join an outstanding one until it turns stale.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest046, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test pending listener join.");
+    constexpr size_t capacity = 4;
+    constexpr std::chrono::milliseconds staleAfter(10000);
+    PendingListenerList listeners("test", capacity);
+    constexpr uint32_t callerTokenId = 1;
+    constexpr uint32_t otherTokenId = 2;
+    bool joined = true;
+    sptr<ScreenLockCallbackInterface> listener = new (std::nothrow) ScreenlockCallbackTest(g_unlockTestListener);
+    EXPECT_EQ(listeners.Add(listener, callerTokenId, staleAfter, joined), E_SCREENLOCK_OK);
+    EXPECT_FALSE(joined);
+    EXPECT_EQ(listeners.Add(listener, callerTokenId, staleAfter, joined), E_SCREENLOCK_OK);
+    EXPECT_TRUE(joined);
+    // Another caller's request is never folded into this one.
+    EXPECT_EQ(listeners.Add(listener, otherTokenId, staleAfter, joined), E_SCREENLOCK_OK);
+    EXPECT_FALSE(joined);
+    listeners.TakeAll();
+    EXPECT_EQ(listeners.Add(listener, callerTokenId, staleAfter, joined), E_SCREENLOCK_OK);
+    EXPECT_FALSE(joined);
+    EXPECT_EQ(listeners.Add(listener, callerTokenId, std::chrono::milliseconds(0), joined), E_SCREENLOCK_OK);
+    EXPECT_FALSE(joined);
+
+    std::string output;
+    listeners.Dump(output);
+    EXPECT_NE(output.find("joined:1"), std::string::npos);
+    listeners.TakeAll();
+}
+
+/**
+* @tc.name: ScreenLockTest047
+* @tc.desc: Test lock state changes are delivered ahead of earlier informational events, each kind in order.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest047, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test critical events overtake informational ones.");
+    EXPECT_TRUE(ScreenLockSystemAbility::IsCriticalEvent(SystemEventId::LOCKSCREEN));
+    EXPECT_TRUE(ScreenLockSystemAbility::IsCriticalEvent(SystemEventId::UNLOCKSCREEN));
+    EXPECT_FALSE(ScreenLockSystemAbility::IsCriticalEvent(SystemEventId::END_SCREEN_ON));
+
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    instance->InitServiceHandler();
+    EventListenerTest eventListener;
+    instance->systemEventListener_ = new ScreenlockNotifyTestInstance(eventListener);
+    {
+        // Hold delivery so the events are still pending when taken here.
+        std::lock_guard<ffrt::mutex> deliveryLock(instance->deliveryMutex_);
+        instance->SystemEventCallBack(SystemEvent(SystemEventId::END_SLEEP));
+        instance->SystemEventCallBack(SystemEvent(SystemEventId::LOCKSCREEN));
+        instance->SystemEventCallBack(SystemEvent(SystemEventId::UNLOCKSCREEN));
+        std::vector<SystemEvent> taken;
+        ScreenLockSystemAbility::PendingSystemEvent pending;
+        while (instance->TakeNextSystemEvent(pending)) {
+            taken.push_back(pending.systemEvent);
+        }
+        ASSERT_GE(taken.size(), 3U);
+        EXPECT_EQ(taken[0].eventId_, SystemEventId::LOCKSCREEN);
+        EXPECT_EQ(taken[1].eventId_, SystemEventId::UNLOCKSCREEN);
+        EXPECT_LT(taken[0].seq_, taken[1].seq_);
+        EXPECT_EQ(taken.back().eventId_, SystemEventId::END_SLEEP);
+    }
+    instance->systemEventListener_ = nullptr;
+}
+
+/**
+* @tc.name: ScreenLockTest048
+* @tc.desc: Test keyguard drawn measures the latency from the last wake up once.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest048, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test keyguard drawn latency.");
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    uint64_t count = instance->wakeToDrawn_.GetCount();
+    instance->wakeUpTimeNs_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    instance->NotifyKeyguardDrawn();
+    EXPECT_EQ(instance->wakeUpTimeNs_, 0);
+    EXPECT_EQ(instance->wakeToDrawn_.GetCount(), count + 1);
+    instance->NotifyKeyguardDrawn();
+    EXPECT_EQ(instance->wakeToDrawn_.GetCount(), count + 1);
+}
+
+/**
+* @tc.name: ScreenLockTest049
+* @tc.desc: Test the per-user state store keeps records across reopen and backs the disabled flag.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest049, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test user state store.");
+    const std::string path = "/data/local/tmp/screenlock_user_state_test.bin";
+    std::remove(path.c_str());
+    {
+        ScreenLockUserStore store;
+        ASSERT_TRUE(store.Open(path));
+        EXPECT_TRUE(store.IsCreated());
+        UserStateRecord record;
+        record.userId = 100;
+        record.isDisabled = true;
+        record.authState = static_cast<int32_t>(AuthState::AUTHED_BY_CREDENTIAL);
+        EXPECT_TRUE(store.Put(record));
+        record.userId = 101;
+        EXPECT_TRUE(store.Put(record));
+        EXPECT_TRUE(store.Remove(101));
+    }
+    ScreenLockUserStore store;
+    ASSERT_TRUE(store.Open(path));
+    EXPECT_FALSE(store.IsCreated());
+    UserStateRecord record;
+    ASSERT_TRUE(store.Get(100, record));
+    EXPECT_TRUE(record.isDisabled);
+    EXPECT_EQ(record.authState, static_cast<int32_t>(AuthState::AUTHED_BY_CREDENTIAL));
+    EXPECT_FALSE(store.Get(101, record));
+    store.Close();
+
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    ASSERT_TRUE(instance->userStore_.Open(path));
+    bool isDisabled = false;
+    EXPECT_TRUE(instance->GetUserDisabled(100, isDisabled));
+    EXPECT_TRUE(isDisabled);
+    EXPECT_TRUE(instance->SetUserDisabled(100, false));
+    EXPECT_TRUE(instance->GetUserDisabled(100, isDisabled));
+    EXPECT_FALSE(isDisabled);
+    instance->InitUserState(102);
+    EXPECT_TRUE(instance->userStore_.Get(102, record));
+    instance->userStore_.Close();
+    std::remove(path.c_str());
+}
+
+/**
+* @tc.name: ScreenLockTest050
+* @tc.desc: Test the user state journal is replayed on open and a torn tail is dropped.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest050, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test user state journal recovery.");
+    const std::string path = "/data/local/tmp/screenlock_user_journal_test.bin";
+    const std::string journalPath = path + ".journal";
+    std::remove(path.c_str());
+    std::remove(journalPath.c_str());
+    constexpr int32_t userCount = 4;
+    constexpr int32_t writeCount = 40;
+    {
+        ScreenLockUserStore store;
+        ASSERT_TRUE(store.Open(path));
+        for (int32_t i = 0; i < writeCount; i++) {
+            UserStateRecord record;
+            record.userId = 100 + i % userCount;
+            record.strongAuthReason = i;
+            EXPECT_TRUE(store.Put(record));
+        }
+        EXPECT_TRUE(store.Sync());
+    }
+    FILE *journal = std::fopen(journalPath.c_str(), "ab");
+    ASSERT_NE(journal, nullptr);
+    std::fputs("torn", journal);
+    std::fclose(journal);
+
+    ScreenLockUserStore store;
+    ASSERT_TRUE(store.Open(path));
+    EXPECT_FALSE(store.IsCreated());
+    EXPECT_EQ(store.GetAll().size(), static_cast<size_t>(userCount));
+    UserStateRecord record;
+    ASSERT_TRUE(store.Get(100 + userCount - 1, record));
+    EXPECT_EQ(record.strongAuthReason, writeCount - 1);
+    EXPECT_EQ(store.compactions_, 1U);
+    EXPECT_EQ(store.journalEntries_, 0U);
+    store.Close();
+    std::remove(path.c_str());
+    std::remove(journalPath.c_str());
+}
+
+/**
+* @tc.name: ScreenLockTest051
+* @tc.desc: Test disabled flags are served from the preloaded cache and written through.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest051, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test disabled flag preload.");
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    constexpr int32_t userId = 100;
+    instance->PreloadUserDisabled();
+    EXPECT_TRUE(instance->disabledCacheLoaded_);
+    EXPECT_TRUE(instance->SetUserDisabled(userId, true));
+    EXPECT_TRUE(instance->disabledCache_[userId]);
+    bool isDisabled = false;
+    EXPECT_TRUE(instance->GetUserDisabled(userId, isDisabled));
+    EXPECT_TRUE(isDisabled);
+    EXPECT_TRUE(instance->SetUserDisabled(userId, false));
+    EXPECT_TRUE(instance->GetUserDisabled(userId, isDisabled));
+    EXPECT_FALSE(isDisabled);
+    instance->disabledCache_.erase(userId);
+    EXPECT_TRUE(instance->GetUserDisabled(userId, isDisabled));
+    EXPECT_FALSE(isDisabled);
+    instance->disabledCacheLoaded_ = false;
+    instance->disabledCache_.clear();
+}
+
+/**
+* @tc.name: ScreenLockTest052
+* @tc.desc: Test a failed write is reported and not cached, and removing an account frees its record.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest052, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test user state store full.");
+    const std::string path = "/data/local/tmp/screenlock_user_full_test.bin";
+    const std::string journalPath = path + ".journal";
+    std::remove(path.c_str());
+    std::remove(journalPath.c_str());
+    sptr<ScreenLockSystemAbility> instance = ScreenLockSystemAbility::GetInstance();
+    ASSERT_TRUE(instance->userStore_.Open(path));
+    constexpr int32_t firstUserId = 1000;
+    constexpr int32_t maxUsers = 1000;
+    int32_t userId = firstUserId;
+    UserStateRecord record;
+    record.userId = userId;
+    while (userId < firstUserId + maxUsers && instance->userStore_.Put(record)) {
+        record.userId = ++userId;
+    }
+    ASSERT_LT(userId, firstUserId + maxUsers);
+    instance->PreloadUserDisabled();
+    EXPECT_FALSE(instance->SetUserDisabled(userId, true));
+    EXPECT_EQ(instance->disabledCache_.count(userId), 0U);
+
+    instance->RemoveUserState(firstUserId);
+    EXPECT_FALSE(instance->userStore_.Get(firstUserId, record));
+    EXPECT_TRUE(instance->SetUserDisabled(userId, true));
+    bool isDisabled = false;
+    EXPECT_TRUE(instance->GetUserDisabled(userId, isDisabled));
+    EXPECT_TRUE(isDisabled);
+    instance->disabledCacheLoaded_ = false;
+    instance->disabledCache_.clear();
+    instance->userStore_.Close();
+    std::remove(path.c_str());
+    std::remove(journalPath.c_str());
+}
+
+/**
+* @tc.name: ScreenLockTest053
+* @tc.desc: Test the secure cache is neither read nor filled while credential updates are not tracked.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest053, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test secure cache without credential tracking.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    constexpr int32_t untrackedUserId = 102;
+    service->stateValue_.SetCredentialTracked(false);
+    service->secureCache_.clear();
+    service->IsUserSecure(untrackedUserId);
+    EXPECT_TRUE(service->secureCache_.empty());
+}
+
+/**
+* @tc.name: ScreenLockTest054
+* @tc.desc: Test events published from several threads stay in seq order in the history.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest054, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test concurrent publish keeps the history ordered.");
+    ScreenLockEventBus eventBus;
+    constexpr int32_t threadCount = 4;
+    constexpr int32_t publishTimes = 8;
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&eventBus]() {
+            for (int32_t j = 0; j < publishTimes; j++) {
+                eventBus.Publish(SystemEvent(LOCKSCREEN));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::vector<SystemEvent> events;
+    EXPECT_TRUE(eventBus.GetEventsSince(0, events));
+    ASSERT_EQ(events.size(), static_cast<size_t>(threadCount * publishTimes));
+    for (size_t i = 0; i < events.size(); i++) {
+        EXPECT_EQ(events[i].seq_, i + 1);
+    }
+    EXPECT_EQ(eventBus.GetLatestSeq(), events.size());
+}
+
+/**
+* @tc.name: ScreenLockTest055
+* @tc.desc: Test the shared state page follows the foreground user across an account switch.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest055, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test current user published on account switch.");
+    auto service = ScreenLockSystemAbility::GetInstance();
+    EXPECT_TRUE(service->stateValue_.InitSharedState());
+    sptr<Ashmem> ashmem = nullptr;
+    bool isLockQueryAllowed = false;
+    EXPECT_EQ(service->GetSharedState(ashmem, isLockQueryAllowed), E_SCREENLOCK_OK);
+    ScreenLockSharedState reader;
+    EXPECT_TRUE(reader.Attach(ashmem));
+
+    int32_t lastUser = service->stateValue_.GetCurrentUser();
+    constexpr int32_t switchedUserId = 103;
+    AccountSA::OsAccountSubscribeInfo subscribeInfo;
+    ScreenLockSystemAbility::AccountSubscriber subscriber(subscribeInfo);
+    subscriber.OnAccountsChanged(switchedUserId);
+    SharedStateSnapshot snapshot;
+    EXPECT_TRUE(reader.Read(snapshot));
+    EXPECT_EQ(snapshot.currentUser, switchedUserId);
+
+    // A lock app reconnect resets its own state only.
+    service->stateValue_.Reset();
+    EXPECT_EQ(service->stateValue_.GetCurrentUser(), switchedUserId);
+    service->RemoveUserState(switchedUserId);
+    service->stateValue_.SetCurrentUser(lastUser);
+}
+
+/**
+* @tc.name: ScreenLockTest056
+* @tc.desc: Test a cached permission verdict is asked again once it expires.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(ScreenLockServiceTest, ScreenLockTest056, TestSize.Level0)
+{
+    SCLOCK_HILOGD("Test permission cache entry expiry.");
+    auto cache = PermissionCache::GetInstance();
+    bool isCacheEnabled = cache->isCacheEnabled_;
+    cache->isCacheEnabled_ = true;
+    cache->Clear();
+    AccessTokenID tokenId = IPCSkeleton::GetCallingTokenID();
+    std::string permission = "ohos.permission.ACCESS_SCREEN_LOCK_INNER";
+    cache->VerifyAccessToken(tokenId, permission);
+    ASSERT_FALSE(cache->lruList_.empty());
+    cache->lruList_.front().expireTime = std::chrono::steady_clock::now();
+    uint64_t misses = cache->misses_;
+    cache->VerifyAccessToken(tokenId, permission);
+    EXPECT_EQ(cache->misses_, misses + 1);
+    EXPECT_EQ(cache->lruList_.size(), 1U);
+    cache->Clear();
+    cache->isCacheEnabled_ = isCacheEnabled;
+}
+
 } // namespace ScreenLock
 } // namespace OHOS
\ No newline at end of file
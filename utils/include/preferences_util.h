@@ -17,8 +17,13 @@
 #define SCREENLOCK_MANAGER_PREFERENCES_UTILS_H
 
 #include <stdint.h>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <variant>
 
+#include "nocopyable.h"
 #include "preferences.h"
 #include "preferences_errno.h"
 #include "singleton.h"
@@ -29,6 +34,13 @@ class PreferencesUtil : public DelayedSingleton<PreferencesUtil> {
     DECLARE_DELAYED_SINGLETON(PreferencesUtil);
 
 public:
+    class Transaction;
+
+    /**
+     * Save* and RemoveKey only update the in-memory cache and always return E_OK; the write reaches disk
+     * with a later delayed flush. Write errors surface only from RefreshSync, and a failed flush keeps
+     * the pending writes and retries with a growing delay, a bounded number of times.
+     */
     int SaveString(const std::string &key, const std::string &value);
     std::string ObtainString(const std::string &key, const std::string &defValue);
     int SaveInt(const std::string &key, int value);
@@ -39,6 +51,7 @@ public:
     int64_t ObtainLong(const std::string &key, int64_t defValue);
     int SaveFloat(const std::string &key, float value);
     float ObtainFloat(const std::string &key, float defValue);
+    std::map<std::string, bool> ObtainAllBool();
     bool IsExistKey(const std::string &key);
     int RemoveKey(const std::string &key);
     int RemoveAll();
@@ -47,12 +60,65 @@ public:
     int DeleteProfiles();
 
 private:
+    using CacheValue = std::variant<std::string, int, bool, int64_t, float>;
+    // std::nullopt records a key known to be absent, or a removal waiting to be flushed.
+    using CacheEntry = std::optional<CacheValue>;
+
     std::shared_ptr<NativePreferences::Preferences> GetProfiles(const std::string &path, int &errCode);
+    template<typename T>
+    int SaveValue(const std::string &key, const T &value);
+    template<typename T>
+    T ObtainValue(const std::string &key, const T &defValue);
+    bool FindEntry(const std::string &key, CacheEntry &entry);
+    void ScheduleFlush();
+    int FlushDirty();
+    void RequeueDirty(const std::map<std::string, CacheEntry> &dirty);
 
 private:
     std::string path_ = "/data/service/el1/public/screenlock/screenlock_state.xml";
     int errCode_ = NativePreferences::E_OK;
     const std::string error_ = "error";
+    // Write-back cache: reads are served from cache_, writes are collected in dirty_ and
+    // persisted by one delayed flush however many arrive before it runs.
+    std::mutex cacheMutex_;
+    std::map<std::string, CacheEntry> cache_;
+    std::map<std::string, CacheEntry> dirty_;
+    bool flushScheduled_ = false;
+    // Consecutive failed flushes, stretches the delay of the next one.
+    uint32_t flushFailures_ = 0;
+    // Bumped when the whole store is cleared, so a load racing with it is not cached.
+    uint64_t cacheGeneration_ = 0;
+    std::mutex flushMutex_;
+    std::mutex transactionMutex_;
+};
+
+/**
+ * Stages mutations and applies them to the cache together on Commit, persisted with a single FlushSync.
+ * Transactions are serialized against each other, so a read-check-write inside one is not interleaved
+ * with another. Reads see the staged values; changes not committed are discarded.
+ */
+class PreferencesUtil::Transaction {
+public:
+    explicit Transaction(PreferencesUtil &preferencesUtil);
+    ~Transaction() = default;
+    DISALLOW_COPY_AND_MOVE(Transaction);
+
+    int SaveString(const std::string &key, const std::string &value);
+    std::string ObtainString(const std::string &key, const std::string &defValue);
+    int SaveInt(const std::string &key, int value);
+    int ObtainInt(const std::string &key, int defValue);
+    int SaveBool(const std::string &key, bool value);
+    bool ObtainBool(const std::string &key, bool defValue);
+    int RemoveKey(const std::string &key);
+    int Commit();
+
+private:
+    template<typename T>
+    T ObtainValue(const std::string &key, const T &defValue);
+
+    PreferencesUtil &preferencesUtil_;
+    std::lock_guard<std::mutex> lock_;
+    std::map<std::string, CacheEntry> staged_;
 };
 } // namespace ScreenLock
 } // namespace OHOS
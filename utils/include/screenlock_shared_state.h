@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_SHARED_STATE_H
+#define SCREENLOCK_SHARED_STATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "ashmem.h"
+#include "nocopyable.h"
+#include "refbase.h"
+
+namespace OHOS {
+namespace ScreenLock {
+struct SharedStateSnapshot {
+    bool isScreenlocked = false;
+    int32_t screenState = 0;
+    int32_t interactiveState = 0;
+    int32_t currentUser = 0;
+    int32_t offReason = 0;
+    bool credentialTracked = false;
+    uint64_t credentialEpoch = 0;
+    uint64_t generation = 0;
+};
+
+/**
+ * Lock state published by the service into a read-only ashmem page.
+ * The service is the only writer; readers use the sequence counter (seqlock)
+ * and retry while a write is in progress, so no IPC or lock is needed to read.
+ */
+class ScreenLockSharedState {
+public:
+    ScreenLockSharedState() = default;
+    ~ScreenLockSharedState();
+    DISALLOW_COPY_AND_MOVE(ScreenLockSharedState);
+
+    bool Create();
+    bool Attach(const sptr<Ashmem> &ashmem);
+    sptr<Ashmem> GetAshmem() const;
+    void Write(const SharedStateSnapshot &snapshot);
+    bool Read(SharedStateSnapshot &snapshot) const;
+    bool IsValid() const;
+
+private:
+    struct Layout {
+        uint32_t magic;
+        uint32_t version;
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> isScreenlocked;
+        std::atomic<int32_t> screenState;
+        std::atomic<int32_t> interactiveState;
+        std::atomic<int32_t> currentUser;
+        std::atomic<int32_t> offReason;
+        std::atomic<uint32_t> credentialTracked;
+        std::atomic<uint64_t> credentialEpoch;
+        std::atomic<uint64_t> generation;
+    };
+
+    bool Map(const sptr<Ashmem> &ashmem, int prot);
+    void Release();
+
+    std::mutex writeMutex_;
+    sptr<Ashmem> ashmem_;
+    Layout *layout_ = nullptr;
+    int32_t mapSize_ = 0;
+    bool writable_ = false;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_SHARED_STATE_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCREENLOCK_USER_STORE_H
+#define SCREENLOCK_USER_STORE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace ScreenLock {
+struct UserStateRecord {
+    int32_t userId = -1;
+    bool isDisabled = false;
+    // Last auth and strong auth state reported for the user, kept as hints only.
+    int32_t authState = 0;
+    int32_t strongAuthReason = 0;
+    // Milliseconds since the epoch.
+    int64_t disabledUpdateTime = 0;
+    int64_t authUpdateTime = 0;
+};
+
+/**
+ * Per-user screen lock state in a fixed-size binary file, loaded into memory once.
+ * The file is a checksummed header followed by one fixed-size slot per user, so a lookup is a
+ * memory read through an in-memory index and a write touches one slot. Slots with a bad
+ * checksum are dropped when the file is opened.
+ * Writes change only the in-memory image and are appended to a journal next to the file. Writes arriving
+ * within a short window share one fsync, and once the journal grows the image is written to a new file
+ * swapped in by rename. The store file is never written in place. Open replays the journal up to its
+ * first damaged entry.
+ * Put and Remove return before that fsync: a write is durable only once the group commit has run,
+ * about 20 ms later, or after Sync. A power cut inside the window loses it, but never tears the file.
+ */
+class ScreenLockUserStore {
+public:
+    ScreenLockUserStore() = default;
+    ~ScreenLockUserStore();
+    DISALLOW_COPY_AND_MOVE(ScreenLockUserStore);
+
+    bool Open(const std::string &path);
+    void Close();
+    bool IsValid() const;
+    // True when Open created the file or had to reset it, the caller then migrates the old state in.
+    bool IsCreated() const;
+    bool Get(int32_t userId, UserStateRecord &record);
+    bool Put(const UserStateRecord &record);
+    bool Remove(int32_t userId);
+    std::vector<UserStateRecord> GetAll();
+    // Makes every write so far durable without waiting for the group commit.
+    bool Sync();
+    void Dump(std::string &output);
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t slotSize;
+        uint32_t checksum;
+        uint32_t reserved;
+    };
+    struct Slot {
+        int32_t userId;
+        uint32_t flags;
+        int32_t authState;
+        int32_t strongAuthReason;
+        int64_t disabledUpdateTime;
+        int64_t authUpdateTime;
+        uint32_t checksum;
+        uint32_t reserved;
+    };
+
+    struct JournalEntry {
+        uint32_t magic;
+        uint32_t reserved;
+        Slot slot;
+        uint32_t checksum;
+        uint32_t padding;
+    };
+    struct Journal;
+
+    void Load(int fd);
+    void Release();
+    void InitHeader();
+    void LoadIndex();
+    void WriteSlot(uint32_t index, const Slot &slot);
+    bool CommitSlot(const Slot &slot);
+    bool ApplySlot(const Slot &slot);
+    bool OpenJournal();
+    uint32_t ReplayJournal(int fd);
+    bool AppendJournal(const Slot &slot);
+    void ScheduleSync();
+    static bool SyncJournal(Journal &journal);
+    bool Compact();
+    static uint32_t Checksum(const void *data, size_t size);
+    static uint32_t HeaderChecksum(const Header &header);
+    static uint32_t SlotChecksum(const Slot &slot);
+    static uint32_t EntryChecksum(const JournalEntry &entry);
+
+    std::mutex mutex_;
+    std::string path_;
+    std::unique_ptr<uint8_t[]> image_;
+    Header *header_ = nullptr;
+    Slot *slots_ = nullptr;
+    size_t imageSize_ = 0;
+    bool created_ = false;
+    std::unordered_map<int32_t, uint32_t> index_;
+    std::vector<uint32_t> freeSlots_;
+    // Shared with the pending group commit task, which must not outlive the file it syncs.
+    std::shared_ptr<Journal> journal_;
+    uint32_t journalEntries_ = 0;
+    uint64_t compactions_ = 0;
+};
+} // namespace ScreenLock
+} // namespace OHOS
+#endif // SCREENLOCK_USER_STORE_H
@@ -15,13 +15,64 @@
 
 #include "preferences_util.h"
 
+#include <algorithm>
+#include <type_traits>
+
+#include "ffrt.h"
 #include "preferences.h"
 #include "preferences_helper.h"
 #include "preferences_observer.h"
+#include "sclock_log.h"
 #include "string"
 
 namespace OHOS {
 namespace ScreenLock {
+namespace {
+// Writes arriving within this window share one flush.
+constexpr uint64_t FLUSH_DELAY_US = 100000;
+// A failing flush is retried with the delay doubled each time, up to 2^6 times the window,
+// and left for the next write or RefreshSync after this many attempts.
+constexpr uint32_t MAX_FLUSH_BACKOFF_SHIFT = 6;
+constexpr uint32_t MAX_FLUSH_RETRIES = 8;
+
+template<typename T>
+bool HoldsType(const NativePreferences::PreferencesValue &value)
+{
+    if constexpr (std::is_same_v<T, std::string>) {
+        return value.IsString();
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return value.IsBool();
+    } else if constexpr (std::is_same_v<T, int>) {
+        return value.IsInt();
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return value.IsLong();
+    } else {
+        return value.IsFloat();
+    }
+}
+
+template<typename Variant>
+int PutValue(NativePreferences::Preferences &preferences, const std::string &key, const Variant &value)
+{
+    return std::visit(
+        [&preferences, &key](const auto &typedValue) -> int {
+            using T = std::decay_t<decltype(typedValue)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                return preferences.PutString(key, typedValue);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return preferences.PutBool(key, typedValue);
+            } else if constexpr (std::is_same_v<T, int>) {
+                return preferences.PutInt(key, typedValue);
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                return preferences.PutLong(key, typedValue);
+            } else {
+                return preferences.PutFloat(key, typedValue);
+            }
+        },
+        value);
+}
+} // namespace
+
 PreferencesUtil::PreferencesUtil() {}
 PreferencesUtil::~PreferencesUtil() {}
 
@@ -32,111 +83,156 @@ std::shared_ptr<NativePreferences::Preferences> PreferencesUtil::GetProfiles(con
 
 int PreferencesUtil::DeleteProfiles()
 {
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        cacheGeneration_++;
+        cache_.clear();
+        dirty_.clear();
+    }
     return NativePreferences::PreferencesHelper::DeletePreferences(path_);
 }
 
-int PreferencesUtil::SaveString(const std::string &key, const std::string &value)
+template<typename T>
+int PreferencesUtil::SaveValue(const std::string &key, const T &value)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        cache_[key] = CacheValue(value);
+        dirty_[key] = CacheValue(value);
     }
-    int ret = ptr->PutString(key, value);
-    ptr->Flush();
-    return ret;
+    ScheduleFlush();
+    return NativePreferences::E_OK;
 }
 
-std::string PreferencesUtil::ObtainString(const std::string &key, const std::string &defValue)
+template<typename T>
+T PreferencesUtil::ObtainValue(const std::string &key, const T &defValue)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto iter = cache_.find(key);
+        if (iter != cache_.end()) {
+            const CacheEntry &entry = iter->second;
+            return entry.has_value() && std::holds_alternative<T>(*entry) ? std::get<T>(*entry) : defValue;
+        }
+        generation = cacheGeneration_;
+    }
+    // First read of the key, load it once without the lock so cached reads and writes do not wait on disk.
+    int errCode = NativePreferences::E_OK;
+    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode);
     if (ptr == nullptr) {
         return defValue;
     }
-    return ptr->GetString(key, defValue);
+    CacheEntry loaded = std::nullopt;
+    T value = defValue;
+    if (ptr->HasKey(key)) {
+        NativePreferences::PreferencesValue stored = ptr->Get(key, NativePreferences::PreferencesValue(defValue));
+        if (!HoldsType<T>(stored)) {
+            // Stored under another type: leave it uncached rather than pinning this caller's default.
+            return defValue;
+        }
+        value = static_cast<T>(stored);
+        loaded = CacheValue(value);
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    // The store was cleared meanwhile, the loaded value may already be gone.
+    if (generation != cacheGeneration_) {
+        return value;
+    }
+    auto [iter, inserted] = cache_.emplace(key, loaded);
+    if (inserted) {
+        return value;
+    }
+    // A write made meanwhile is newer than the loaded value.
+    const CacheEntry &entry = iter->second;
+    return entry.has_value() && std::holds_alternative<T>(*entry) ? std::get<T>(*entry) : defValue;
 }
 
-int PreferencesUtil::SaveInt(const std::string &key, int value)
+bool PreferencesUtil::FindEntry(const std::string &key, CacheEntry &entry)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        entry = iter->second;
+        return true;
     }
-    int ret = ptr->PutInt(key, value);
-    ptr->Flush();
-    return ret;
+    return false;
+}
+
+int PreferencesUtil::SaveString(const std::string &key, const std::string &value)
+{
+    return SaveValue(key, value);
+}
+
+std::string PreferencesUtil::ObtainString(const std::string &key, const std::string &defValue)
+{
+    return ObtainValue(key, defValue);
+}
+
+int PreferencesUtil::SaveInt(const std::string &key, int value)
+{
+    return SaveValue(key, value);
 }
 
 int PreferencesUtil::ObtainInt(const std::string &key, int defValue)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return defValue;
-    }
-    return ptr->GetInt(key, defValue);
+    return ObtainValue(key, defValue);
 }
 
 int PreferencesUtil::SaveBool(const std::string &key, bool value)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
-    }
-    int ret = ptr->PutBool(key, value);
-    ptr->Flush();
-    return ret;
+    return SaveValue(key, value);
 }
 
 bool PreferencesUtil::ObtainBool(const std::string &key, bool defValue)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return defValue;
-    }
-    return ptr->GetBool(key, defValue);
+    return ObtainValue(key, defValue);
 }
 
 int PreferencesUtil::SaveLong(const std::string &key, int64_t value)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
-    }
-    int ret = ptr->PutLong(key, value);
-    ptr->Flush();
-    return ret;
+    return SaveValue(key, value);
 }
 
 int64_t PreferencesUtil::ObtainLong(const std::string &key, int64_t defValue)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return defValue;
-    }
-    return ptr->GetLong(key, defValue);
+    return ObtainValue(key, defValue);
 }
 
 int PreferencesUtil::SaveFloat(const std::string &key, float value)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
-    }
-    int ret = ptr->PutFloat(key, value);
-    ptr->Flush();
-    return ret;
+    return SaveValue(key, value);
 }
 
 float PreferencesUtil::ObtainFloat(const std::string &key, float defValue)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
+    return ObtainValue(key, defValue);
+}
+
+std::map<std::string, bool> PreferencesUtil::ObtainAllBool()
+{
+    std::map<std::string, bool> values;
+    FlushDirty();
+    int errCode = NativePreferences::E_OK;
+    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode);
     if (ptr == nullptr) {
-        return defValue;
+        return values;
     }
-    return ptr->GetFloat(key, defValue);
+    for (const auto &[key, value] : ptr->GetAll()) {
+        if (value.IsBool()) {
+            values.emplace(key, static_cast<bool>(value));
+        }
+    }
+    return values;
 }
 
 bool PreferencesUtil::IsExistKey(const std::string &key)
 {
+    CacheEntry entry;
+    if (FindEntry(key, entry)) {
+        return entry.has_value();
+    }
     std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
     if (ptr == nullptr) {
         return NativePreferences::E_ERROR;
@@ -146,37 +242,178 @@ bool PreferencesUtil::IsExistKey(const std::string &key)
 
 int PreferencesUtil::RemoveKey(const std::string &key)
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr == nullptr) {
-        return NativePreferences::E_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        cache_[key] = std::nullopt;
+        dirty_[key] = std::nullopt;
     }
-    return ptr->Delete(key);
+    ScheduleFlush();
+    return NativePreferences::E_OK;
 }
 
 int PreferencesUtil::RemoveAll()
 {
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
     std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
     if (ptr == nullptr) {
         return NativePreferences::E_ERROR;
     }
-    return ptr->Clear();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        cacheGeneration_++;
+        cache_.clear();
+        dirty_.clear();
+    }
+    int ret = ptr->Clear();
+    ptr->Flush();
+    return ret;
 }
 
 void PreferencesUtil::Refresh()
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
-    if (ptr != nullptr) {
-        ptr->Flush();
-    }
+    ScheduleFlush();
 }
 
 int PreferencesUtil::RefreshSync()
 {
-    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode_);
+    return FlushDirty();
+}
+
+void PreferencesUtil::ScheduleFlush()
+{
+    uint64_t delay = FLUSH_DELAY_US;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        if (flushScheduled_ || dirty_.empty()) {
+            return;
+        }
+        flushScheduled_ = true;
+        delay <<= std::min(flushFailures_, MAX_FLUSH_BACKOFF_SHIFT);
+    }
+    ffrt::submit([this]() { FlushDirty(); }, {}, {}, ffrt::task_attr().delay(delay));
+}
+
+int PreferencesUtil::FlushDirty()
+{
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    std::map<std::string, CacheEntry> dirty;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        dirty.swap(dirty_);
+        flushScheduled_ = false;
+    }
+    if (dirty.empty()) {
+        return NativePreferences::E_OK;
+    }
+    int errCode = NativePreferences::E_OK;
+    std::shared_ptr<NativePreferences::Preferences> ptr = GetProfiles(path_, errCode);
     if (ptr == nullptr) {
+        SCLOCK_HILOGE("flush preferences failed, errCode = %{public}d", errCode);
+        RequeueDirty(dirty);
         return NativePreferences::E_ERROR;
     }
-    return ptr->FlushSync();
+    for (const auto &[key, entry] : dirty) {
+        if (entry.has_value()) {
+            PutValue(*ptr, key, *entry);
+        } else {
+            ptr->Delete(key);
+        }
+    }
+    int ret = ptr->FlushSync();
+    if (ret != NativePreferences::E_OK) {
+        SCLOCK_HILOGE("flush preferences failed, ret = %{public}d", ret);
+        RequeueDirty(dirty);
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    flushFailures_ = 0;
+    return ret;
+}
+
+void PreferencesUtil::RequeueDirty(const std::map<std::string, CacheEntry> &dirty)
+{
+    {
+        // Keep the writes for the next flush, unless a newer write to the same key is already pending.
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        dirty_.insert(dirty.begin(), dirty.end());
+        if (++flushFailures_ >= MAX_FLUSH_RETRIES) {
+            SCLOCK_HILOGE("flush preferences failed %{public}u times, wait for the next write", flushFailures_);
+            return;
+        }
+    }
+    ScheduleFlush();
+}
+
+PreferencesUtil::Transaction::Transaction(PreferencesUtil &preferencesUtil)
+    : preferencesUtil_(preferencesUtil), lock_(preferencesUtil.transactionMutex_)
+{
+}
+
+template<typename T>
+T PreferencesUtil::Transaction::ObtainValue(const std::string &key, const T &defValue)
+{
+    auto iter = staged_.find(key);
+    if (iter == staged_.end()) {
+        return preferencesUtil_.ObtainValue(key, defValue);
+    }
+    const CacheEntry &entry = iter->second;
+    return entry.has_value() && std::holds_alternative<T>(*entry) ? std::get<T>(*entry) : defValue;
+}
+
+int PreferencesUtil::Transaction::SaveString(const std::string &key, const std::string &value)
+{
+    staged_[key] = CacheValue(value);
+    return NativePreferences::E_OK;
+}
+
+std::string PreferencesUtil::Transaction::ObtainString(const std::string &key, const std::string &defValue)
+{
+    return ObtainValue(key, defValue);
+}
+
+int PreferencesUtil::Transaction::SaveInt(const std::string &key, int value)
+{
+    staged_[key] = CacheValue(value);
+    return NativePreferences::E_OK;
+}
+
+int PreferencesUtil::Transaction::ObtainInt(const std::string &key, int defValue)
+{
+    return ObtainValue(key, defValue);
+}
+
+int PreferencesUtil::Transaction::SaveBool(const std::string &key, bool value)
+{
+    staged_[key] = CacheValue(value);
+    return NativePreferences::E_OK;
+}
+
+bool PreferencesUtil::Transaction::ObtainBool(const std::string &key, bool defValue)
+{
+    return ObtainValue(key, defValue);
+}
+
+int PreferencesUtil::Transaction::RemoveKey(const std::string &key)
+{
+    staged_[key] = std::nullopt;
+    return NativePreferences::E_OK;
+}
+
+int PreferencesUtil::Transaction::Commit()
+{
+    if (staged_.empty()) {
+        return NativePreferences::E_OK;
+    }
+    {
+        std::lock_guard<std::mutex> lock(preferencesUtil_.cacheMutex_);
+        for (const auto &[key, entry] : staged_) {
+            preferencesUtil_.cache_[key] = entry;
+            preferencesUtil_.dirty_[key] = entry;
+        }
+    }
+    staged_.clear();
+    // Also carries any earlier writes still waiting for the delayed flush.
+    return preferencesUtil_.FlushDirty();
 }
-} // namespace Telephony
-} // namespace OHOS
\ No newline at end of file
+} // namespace ScreenLock
+} // namespace OHOS
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "screenlock_shared_state.h"
+
+#include <new>
+#include <sys/mman.h>
+
+#include "sclock_log.h"
+
+namespace OHOS {
+namespace ScreenLock {
+namespace {
+constexpr const char *SHARED_STATE_NAME = "screenlock_shared_state";
+constexpr uint32_t SHARED_STATE_MAGIC = 0x534C4B53; // "SLKS"
+constexpr uint32_t SHARED_STATE_VERSION = 2;
+constexpr int32_t READ_RETRY_TIMES = 64;
+} // namespace
+
+ScreenLockSharedState::~ScreenLockSharedState()
+{
+    Release();
+}
+
+bool ScreenLockSharedState::Create()
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Release();
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem(SHARED_STATE_NAME, sizeof(Layout));
+    if (ashmem == nullptr) {
+        SCLOCK_HILOGE("create shared state ashmem failed");
+        return false;
+    }
+    if (!Map(ashmem, PROT_READ | PROT_WRITE)) {
+        ashmem->CloseAshmem();
+        return false;
+    }
+    new (layout_) Layout();
+    layout_->magic = SHARED_STATE_MAGIC;
+    layout_->version = SHARED_STATE_VERSION;
+    // The mapping above stays writable; every later mapping of the fd is read-only.
+    if (!ashmem->SetProtection(PROT_READ)) {
+        SCLOCK_HILOGE("set shared state protection failed");
+        Release();
+        ashmem->CloseAshmem();
+        return false;
+    }
+    ashmem_ = ashmem;
+    writable_ = true;
+    return true;
+}
+
+bool ScreenLockSharedState::Attach(const sptr<Ashmem> &ashmem)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Release();
+    if (ashmem == nullptr || ashmem->GetAshmemSize() < static_cast<int32_t>(sizeof(Layout))) {
+        SCLOCK_HILOGE("invalid shared state ashmem");
+        return false;
+    }
+    if (!Map(ashmem, PROT_READ)) {
+        return false;
+    }
+    if (layout_->magic != SHARED_STATE_MAGIC || layout_->version != SHARED_STATE_VERSION) {
+        SCLOCK_HILOGE("shared state layout mismatch, version = %{public}u", layout_->version);
+        Release();
+        return false;
+    }
+    ashmem_ = ashmem;
+    writable_ = false;
+    return true;
+}
+
+sptr<Ashmem> ScreenLockSharedState::GetAshmem() const
+{
+    return ashmem_;
+}
+
+void ScreenLockSharedState::Write(const SharedStateSnapshot &snapshot)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (layout_ == nullptr || !writable_) {
+        return;
+    }
+    uint32_t sequence = layout_->sequence.load(std::memory_order_relaxed);
+    layout_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    layout_->isScreenlocked.store(snapshot.isScreenlocked ? 1 : 0, std::memory_order_relaxed);
+    layout_->screenState.store(snapshot.screenState, std::memory_order_relaxed);
+    layout_->interactiveState.store(snapshot.interactiveState, std::memory_order_relaxed);
+    layout_->currentUser.store(snapshot.currentUser, std::memory_order_relaxed);
+    layout_->offReason.store(snapshot.offReason, std::memory_order_relaxed);
+    layout_->credentialTracked.store(snapshot.credentialTracked ? 1 : 0, std::memory_order_relaxed);
+    layout_->credentialEpoch.store(snapshot.credentialEpoch, std::memory_order_relaxed);
+    layout_->generation.fetch_add(1, std::memory_order_relaxed);
+    layout_->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool ScreenLockSharedState::Read(SharedStateSnapshot &snapshot) const
+{
+    if (layout_ == nullptr) {
+        return false;
+    }
+    for (int32_t i = 0; i < READ_RETRY_TIMES; i++) {
+        uint32_t begin = layout_->sequence.load(std::memory_order_acquire);
+        if ((begin & 1) != 0) {
+            continue;
+        }
+        SharedStateSnapshot value;
+        value.isScreenlocked = layout_->isScreenlocked.load(std::memory_order_relaxed) != 0;
+        value.screenState = layout_->screenState.load(std::memory_order_relaxed);
+        value.interactiveState = layout_->interactiveState.load(std::memory_order_relaxed);
+        value.currentUser = layout_->currentUser.load(std::memory_order_relaxed);
+        value.offReason = layout_->offReason.load(std::memory_order_relaxed);
+        value.credentialTracked = layout_->credentialTracked.load(std::memory_order_relaxed) != 0;
+        value.credentialEpoch = layout_->credentialEpoch.load(std::memory_order_relaxed);
+        value.generation = layout_->generation.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (layout_->sequence.load(std::memory_order_relaxed) == begin) {
+            snapshot = value;
+            return true;
+        }
+    }
+    SCLOCK_HILOGW("read shared state contended");
+    return false;
+}
+
+bool ScreenLockSharedState::IsValid() const
+{
+    return layout_ != nullptr;
+}
+
+bool ScreenLockSharedState::Map(const sptr<Ashmem> &ashmem, int prot)
+{
+    int32_t size = static_cast<int32_t>(sizeof(Layout));
+    void *addr = mmap(nullptr, size, prot, MAP_SHARED, ashmem->GetAshmemFd(), 0);
+    if (addr == MAP_FAILED) {
+        SCLOCK_HILOGE("map shared state failed, prot = %{public}d", prot);
+        return false;
+    }
+    layout_ = static_cast<Layout *>(addr);
+    mapSize_ = size;
+    return true;
+}
+
+void ScreenLockSharedState::Release()
+{
+    if (layout_ != nullptr) {
+        munmap(layout_, mapSize_);
+        layout_ = nullptr;
+        mapSize_ = 0;
+    }
+    if (ashmem_ != nullptr) {
+        ashmem_->CloseAshmem();
+        ashmem_ = nullptr;
+    }
+    writable_ = false;
+}
+} // namespace ScreenLock
+} // namespace OHOS
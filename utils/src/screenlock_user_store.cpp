@@ -0,0 +1,514 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "screenlock_user_store.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ffrt.h"
+#include "sclock_log.h"
+
+namespace OHOS {
+namespace ScreenLock {
+namespace {
+constexpr uint32_t USER_STORE_MAGIC = 0x534C5553; // "SLUS"
+constexpr uint32_t USER_STORE_VERSION = 1;
+constexpr uint32_t USER_STORE_SLOTS = 64;
+constexpr uint32_t SLOT_IN_USE = 1U << 0;
+constexpr uint32_t SLOT_DISABLED = 1U << 1;
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME = 16777619U;
+constexpr mode_t USER_STORE_MODE = 0600;
+constexpr uint32_t JOURNAL_ENTRY_MAGIC = 0x534C554A; // "SLUJ"
+// Writes arriving within this window share one fsync of the journal.
+constexpr uint64_t JOURNAL_SYNC_DELAY_US = 20000;
+// The journal is folded into the store file once it holds this many entries.
+constexpr uint32_t JOURNAL_COMPACT_ENTRIES = 128;
+constexpr const char *JOURNAL_SUFFIX = ".journal";
+constexpr const char *TEMP_SUFFIX = ".tmp";
+
+bool WriteAll(int fd, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void SyncDirectory(const std::string &path)
+{
+    size_t pos = path.rfind('/');
+    std::string dir = pos == std::string::npos ? "." : path.substr(0, pos);
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    fsync(fd);
+    close(fd);
+}
+} // namespace
+
+struct ScreenLockUserStore::Journal {
+    std::mutex mutex;
+    int fd = -1;
+    bool syncScheduled = false;
+    uint64_t appended = 0;
+    uint64_t syncs = 0;
+};
+
+ScreenLockUserStore::~ScreenLockUserStore()
+{
+    Close();
+}
+
+bool ScreenLockUserStore::Open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ != nullptr) {
+        return true;
+    }
+    path_ = path;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 && errno != ENOENT) {
+        SCLOCK_HILOGE("open user store failed, errno = %{public}d", errno);
+        return false;
+    }
+    Load(fd);
+    if (fd >= 0) {
+        close(fd);
+    }
+    uint64_t compactions = compactions_;
+    if (!OpenJournal()) {
+        SCLOCK_HILOGW("open user store journal failed, writes are synced one by one");
+    }
+    // A replayed journal was already folded in by OpenJournal.
+    if (created_ && compactions_ == compactions && !Compact()) {
+        Release();
+        return false;
+    }
+    return true;
+}
+
+void ScreenLockUserStore::Load(int fd)
+{
+    imageSize_ = sizeof(Header) + sizeof(Slot) * USER_STORE_SLOTS;
+    image_ = std::make_unique<uint8_t[]>(imageSize_);
+    header_ = reinterpret_cast<Header *>(image_.get());
+    slots_ = reinterpret_cast<Slot *>(image_.get() + sizeof(Header));
+    struct stat fileStat = {};
+    bool reset = fd < 0 || fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) != imageSize_ ||
+        pread(fd, image_.get(), imageSize_, 0) != static_cast<ssize_t>(imageSize_);
+    if (!reset && (header_->magic != USER_STORE_MAGIC || header_->version != USER_STORE_VERSION ||
+        header_->slotCount != USER_STORE_SLOTS || header_->slotSize != sizeof(Slot) ||
+        header_->checksum != HeaderChecksum(*header_))) {
+        SCLOCK_HILOGW("user store header invalid, version = %{public}u, reset it", header_->version);
+        reset = true;
+    }
+    if (reset) {
+        InitHeader();
+    }
+    created_ = reset;
+    LoadIndex();
+}
+
+void ScreenLockUserStore::InitHeader()
+{
+    for (uint32_t i = 0; i < USER_STORE_SLOTS; i++) {
+        slots_[i] = {};
+    }
+    header_->magic = USER_STORE_MAGIC;
+    header_->version = USER_STORE_VERSION;
+    header_->slotCount = USER_STORE_SLOTS;
+    header_->slotSize = sizeof(Slot);
+    header_->reserved = 0;
+    header_->checksum = HeaderChecksum(*header_);
+}
+
+void ScreenLockUserStore::LoadIndex()
+{
+    index_.clear();
+    freeSlots_.clear();
+    for (uint32_t i = USER_STORE_SLOTS; i > 0; i--) {
+        uint32_t slotIndex = i - 1;
+        const Slot &slot = slots_[slotIndex];
+        if ((slot.flags & SLOT_IN_USE) == 0) {
+            freeSlots_.push_back(slotIndex);
+            continue;
+        }
+        if (slot.checksum != SlotChecksum(slot) || index_.count(slot.userId) != 0) {
+            SCLOCK_HILOGW("drop torn user store slot %{public}u", slotIndex);
+            WriteSlot(slotIndex, {});
+            freeSlots_.push_back(slotIndex);
+            continue;
+        }
+        index_.emplace(slot.userId, slotIndex);
+    }
+}
+
+void ScreenLockUserStore::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Release();
+}
+
+void ScreenLockUserStore::Release()
+{
+    if (journal_ != nullptr) {
+        std::lock_guard<std::mutex> journalLock(journal_->mutex);
+        fdatasync(journal_->fd);
+        close(journal_->fd);
+        journal_->fd = -1;
+        journal_ = nullptr;
+    }
+    journalEntries_ = 0;
+    image_ = nullptr;
+    header_ = nullptr;
+    slots_ = nullptr;
+    index_.clear();
+    freeSlots_.clear();
+}
+
+bool ScreenLockUserStore::IsValid() const
+{
+    return header_ != nullptr;
+}
+
+bool ScreenLockUserStore::IsCreated() const
+{
+    return created_;
+}
+
+bool ScreenLockUserStore::Get(int32_t userId, UserStateRecord &record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(userId);
+    if (iter == index_.end()) {
+        return false;
+    }
+    const Slot &slot = slots_[iter->second];
+    record.userId = slot.userId;
+    record.isDisabled = (slot.flags & SLOT_DISABLED) != 0;
+    record.authState = slot.authState;
+    record.strongAuthReason = slot.strongAuthReason;
+    record.disabledUpdateTime = slot.disabledUpdateTime;
+    record.authUpdateTime = slot.authUpdateTime;
+    return true;
+}
+
+bool ScreenLockUserStore::Put(const UserStateRecord &record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr) {
+        return false;
+    }
+    auto iter = index_.find(record.userId);
+    if (iter == index_.end() && freeSlots_.empty()) {
+        SCLOCK_HILOGE("user store is full, userId = %{public}d", record.userId);
+        return false;
+    }
+    Slot slot = {};
+    slot.userId = record.userId;
+    slot.flags = SLOT_IN_USE | (record.isDisabled ? SLOT_DISABLED : 0);
+    slot.authState = record.authState;
+    slot.strongAuthReason = record.strongAuthReason;
+    slot.disabledUpdateTime = record.disabledUpdateTime;
+    slot.authUpdateTime = record.authUpdateTime;
+    slot.checksum = SlotChecksum(slot);
+    if (iter != index_.end() && memcmp(&slots_[iter->second], &slot, sizeof(Slot)) == 0) {
+        return true;
+    }
+    return CommitSlot(slot);
+}
+
+bool ScreenLockUserStore::Remove(int32_t userId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(userId) == 0) {
+        return false;
+    }
+    Slot slot = {};
+    slot.userId = userId;
+    slot.checksum = SlotChecksum(slot);
+    return CommitSlot(slot);
+}
+
+bool ScreenLockUserStore::ApplySlot(const Slot &slot)
+{
+    auto iter = index_.find(slot.userId);
+    if ((slot.flags & SLOT_IN_USE) == 0) {
+        if (iter != index_.end()) {
+            WriteSlot(iter->second, {});
+            freeSlots_.push_back(iter->second);
+            index_.erase(iter);
+        }
+        return true;
+    }
+    uint32_t slotIndex = 0;
+    if (iter != index_.end()) {
+        slotIndex = iter->second;
+    } else if (!freeSlots_.empty()) {
+        slotIndex = freeSlots_.back();
+        freeSlots_.pop_back();
+        index_.emplace(slot.userId, slotIndex);
+    } else {
+        return false;
+    }
+    WriteSlot(slotIndex, slot);
+    return true;
+}
+
+std::vector<UserStateRecord> ScreenLockUserStore::GetAll()
+{
+    std::vector<int32_t> userIds;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &[userId, slotIndex] : index_) {
+            userIds.push_back(userId);
+        }
+    }
+    std::vector<UserStateRecord> records;
+    for (int32_t userId : userIds) {
+        UserStateRecord record;
+        if (Get(userId, record)) {
+            records.push_back(record);
+        }
+    }
+    return records;
+}
+
+void ScreenLockUserStore::WriteSlot(uint32_t index, const Slot &slot)
+{
+    slots_[index] = slot;
+}
+
+bool ScreenLockUserStore::CommitSlot(const Slot &slot)
+{
+    bool journaled = AppendJournal(slot);
+    if (!ApplySlot(slot)) {
+        return false;
+    }
+    // Without the journal the new image has to reach disk before the write returns.
+    if (!journaled || journalEntries_ >= JOURNAL_COMPACT_ENTRIES) {
+        return Compact() || journaled;
+    }
+    return true;
+}
+
+bool ScreenLockUserStore::OpenJournal()
+{
+    int fd = open((path_ + JOURNAL_SUFFIX).c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, USER_STORE_MODE);
+    if (fd < 0) {
+        SCLOCK_HILOGE("open journal failed, errno = %{public}d", errno);
+        return false;
+    }
+    uint32_t replayed = ReplayJournal(fd);
+    journal_ = std::make_shared<Journal>();
+    journal_->fd = fd;
+    journalEntries_ = replayed;
+    if (replayed > 0) {
+        SCLOCK_HILOGI("user store journal replayed, entries = %{public}u", replayed);
+        Compact();
+    }
+    return true;
+}
+
+uint32_t ScreenLockUserStore::ReplayJournal(int fd)
+{
+    uint32_t replayed = 0;
+    off_t offset = 0;
+    JournalEntry entry = {};
+    while (pread(fd, &entry, sizeof(entry), offset) == static_cast<ssize_t>(sizeof(entry))) {
+        if (entry.magic != JOURNAL_ENTRY_MAGIC || entry.checksum != EntryChecksum(entry) ||
+            entry.slot.checksum != SlotChecksum(entry.slot)) {
+            break;
+        }
+        ApplySlot(entry.slot);
+        replayed++;
+        offset += static_cast<off_t>(sizeof(entry));
+    }
+    // Anything after the last complete entry is a write torn by a power cut, cut it off before appending.
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size != offset) {
+        SCLOCK_HILOGW("drop torn journal tail, size = %{public}" PRId64 ", valid = %{public}" PRId64,
+            static_cast<int64_t>(fileStat.st_size), static_cast<int64_t>(offset));
+        ftruncate(fd, offset);
+    }
+    return replayed;
+}
+
+bool ScreenLockUserStore::AppendJournal(const Slot &slot)
+{
+    if (journal_ == nullptr) {
+        return false;
+    }
+    JournalEntry entry = {};
+    entry.magic = JOURNAL_ENTRY_MAGIC;
+    entry.slot = slot;
+    entry.checksum = EntryChecksum(entry);
+    {
+        std::lock_guard<std::mutex> lock(journal_->mutex);
+        if (!WriteAll(journal_->fd, &entry, sizeof(entry))) {
+            SCLOCK_HILOGE("append journal failed, errno = %{public}d", errno);
+            ftruncate(journal_->fd, static_cast<off_t>(journalEntries_ * sizeof(entry)));
+            return false;
+        }
+        journal_->appended++;
+    }
+    journalEntries_++;
+    ScheduleSync();
+    return true;
+}
+
+void ScreenLockUserStore::ScheduleSync()
+{
+    {
+        std::lock_guard<std::mutex> lock(journal_->mutex);
+        if (journal_->syncScheduled) {
+            return;
+        }
+        journal_->syncScheduled = true;
+    }
+    std::weak_ptr<Journal> weakJournal = journal_;
+    ffrt::submit(
+        [weakJournal]() {
+            auto journal = weakJournal.lock();
+            if (journal == nullptr) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(journal->mutex);
+                journal->syncScheduled = false;
+            }
+            SyncJournal(*journal);
+        },
+        {}, {}, ffrt::task_attr().delay(JOURNAL_SYNC_DELAY_US));
+}
+
+bool ScreenLockUserStore::SyncJournal(Journal &journal)
+{
+    std::lock_guard<std::mutex> lock(journal.mutex);
+    if (journal.fd < 0) {
+        return false;
+    }
+    if (fdatasync(journal.fd) != 0) {
+        SCLOCK_HILOGE("sync journal failed, errno = %{public}d", errno);
+        return false;
+    }
+    journal.syncs++;
+    return true;
+}
+
+bool ScreenLockUserStore::Sync()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (journal_ == nullptr) {
+        // Every write was already saved by Compact.
+        return header_ != nullptr;
+    }
+    return SyncJournal(*journal_);
+}
+
+bool ScreenLockUserStore::Compact()
+{
+    // The store file is only ever replaced whole, so it never holds a write the journal has not covered.
+    std::string tempPath = path_ + TEMP_SUFFIX;
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, USER_STORE_MODE);
+    if (fd < 0) {
+        SCLOCK_HILOGE("open temp store failed, errno = %{public}d", errno);
+        return false;
+    }
+    if (!WriteAll(fd, image_.get(), imageSize_) || fsync(fd) != 0) {
+        SCLOCK_HILOGE("write temp store failed, errno = %{public}d", errno);
+        close(fd);
+        unlink(tempPath.c_str());
+        return false;
+    }
+    close(fd);
+    if (rename(tempPath.c_str(), path_.c_str()) != 0) {
+        SCLOCK_HILOGE("rename temp store failed, errno = %{public}d", errno);
+        unlink(tempPath.c_str());
+        return false;
+    }
+    SyncDirectory(path_);
+    compactions_++;
+    if (journal_ == nullptr) {
+        return true;
+    }
+    // Entries left behind by a crash before the truncation are replayed onto the same values.
+    std::lock_guard<std::mutex> lock(journal_->mutex);
+    if (ftruncate(journal_->fd, 0) != 0) {
+        SCLOCK_HILOGE("truncate journal failed, errno = %{public}d", errno);
+        return false;
+    }
+    journalEntries_ = 0;
+    return true;
+}
+
+void ScreenLockUserStore::Dump(std::string &output)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    output.append(" * user store\t\t\tusers:" + std::to_string(index_.size()));
+    if (journal_ != nullptr) {
+        std::lock_guard<std::mutex> journalLock(journal_->mutex);
+        output.append("\tjournal:" + std::to_string(journalEntries_))
+            .append("\tappended:" + std::to_string(journal_->appended))
+            .append("\tsyncs:" + std::to_string(journal_->syncs));
+    }
+    output.append("\tcompactions:" + std::to_string(compactions_) + "\n");
+}
+
+uint32_t ScreenLockUserStore::Checksum(const void *data, size_t size)
+{
+    // FNV-1a, enough to tell a torn or stale record from a complete one.
+    uint32_t hash = FNV_OFFSET_BASIS;
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint32_t ScreenLockUserStore::HeaderChecksum(const Header &header)
+{
+    return Checksum(&header, offsetof(Header, checksum));
+}
+
+uint32_t ScreenLockUserStore::SlotChecksum(const Slot &slot)
+{
+    return Checksum(&slot, offsetof(Slot, checksum));
+}
+
+uint32_t ScreenLockUserStore::EntryChecksum(const JournalEntry &entry)
+{
+    return Checksum(&entry, offsetof(JournalEntry, checksum));
+}
+} // namespace ScreenLock
+} // namespace OHOS